@@ -26,7 +26,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // bgnbd_staticcov_CET
-arma::vec bgnbd_staticcov_CET(const double r, const double alpha, const double a, const double b, const double dPeriods, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_trans, const arma::mat& mCov_life);
+arma::vec bgnbd_staticcov_CET(const double r, const double alpha, const double a, const double b, const double dPeriods, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_trans, SEXP mCov_life);
 RcppExport SEXP _CLVTools_bgnbd_staticcov_CET(SEXP rSEXP, SEXP alphaSEXP, SEXP aSEXP, SEXP bSEXP, SEXP dPeriodsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_transSEXP, SEXP mCov_lifeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -41,8 +41,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
     rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_CET(r, alpha, a, b, dPeriods, vX, vT_x, vT_cal, vCovParams_trans, vCovParams_life, mCov_trans, mCov_life));
     return rcpp_result_gen;
 END_RCPP
@@ -62,8 +62,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // bgnbd_nocov_LL_sum
-double bgnbd_nocov_LL_sum(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
-RcppExport SEXP _CLVTools_bgnbd_nocov_LL_sum(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP) {
+double bgnbd_nocov_LL_sum(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_bgnbd_nocov_LL_sum(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vWeightsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -71,7 +71,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
-    rcpp_result_gen = Rcpp::wrap(bgnbd_nocov_LL_sum(vLogparams, vX, vT_x, vT_cal));
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_nocov_LL_sum(vLogparams, vX, vT_x, vT_cal, vWeights));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -92,8 +93,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // bgnbd_staticcov_LL_sum
-double bgnbd_staticcov_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans);
-RcppExport SEXP _CLVTools_bgnbd_staticcov_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+double bgnbd_staticcov_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -103,7 +104,72 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
     Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_staticcov_sparse_LL_ind
+arma::vec bgnbd_staticcov_sparse_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::sp_mat& mCov_life, const arma::sp_mat& mCov_trans);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_sparse_LL_ind(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_trans(mCov_transSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_sparse_LL_ind(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_staticcov_sparse_LL_sum
+double bgnbd_staticcov_sparse_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::sp_mat& mCov_life, const arma::sp_mat& mCov_trans, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_sparse_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_sparse_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_staticcov_cached_LL_ind
+arma::vec bgnbd_staticcov_cached_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_cached_LL_ind(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP ptrCovCacheSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_cached_LL_ind(vParams, vX, vT_x, vT_cal, ptrCovCache));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_staticcov_cached_LL_sum
+double bgnbd_staticcov_cached_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_cached_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP ptrCovCacheSEXP, SEXP vWeightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_cached_LL_sum(vParams, vX, vT_x, vT_cal, ptrCovCache, vWeights));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -125,7 +191,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // bgnbd_staticcov_PAlive
-arma::vec bgnbd_staticcov_PAlive(const double r, const double alpha, const double a, const double b, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_trans, const arma::mat& mCov_life);
+arma::vec bgnbd_staticcov_PAlive(const double r, const double alpha, const double a, const double b, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_trans, SEXP mCov_life);
 RcppExport SEXP _CLVTools_bgnbd_staticcov_PAlive(SEXP rSEXP, SEXP alphaSEXP, SEXP aSEXP, SEXP bSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_transSEXP, SEXP mCov_lifeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -139,12 +205,217 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
     rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_PAlive(r, alpha, a, b, vX, vT_x, vT_cal, vCovParams_trans, vCovParams_life, mCov_trans, mCov_life));
     return rcpp_result_gen;
 END_RCPP
 }
+// clv_staticcov_cache_new
+SEXP clv_staticcov_cache_new(SEXP mCov_life, const arma::uvec& vPattern_life, SEXP mCov_trans, const arma::uvec& vPattern_trans);
+RcppExport SEXP _CLVTools_clv_staticcov_cache_new(SEXP mCov_lifeSEXP, SEXP vPattern_lifeSEXP, SEXP mCov_transSEXP, SEXP vPattern_transSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::uvec& >::type vPattern_life(vPattern_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::uvec& >::type vPattern_trans(vPattern_transSEXP);
+    rcpp_result_gen = Rcpp::wrap(clv_staticcov_cache_new(mCov_life, vPattern_life, mCov_trans, vPattern_trans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// clv_objective_new
+SEXP clv_objective_new(const std::string& kernel, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vWeights, SEXP ptrCovCache, const arma::vec& vParamIndex, const bool bUseReg, const double dRegLambdaLife, const double dRegLambdaTrans, const double dNumObservations, const arma::vec& vRegIndexLife, const arma::vec& vRegIndexTrans, const int iCorIndex);
+RcppExport SEXP _CLVTools_clv_objective_new(SEXP kernelSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vWeightsSEXP, SEXP ptrCovCacheSEXP, SEXP vParamIndexSEXP, SEXP bUseRegSEXP, SEXP dRegLambdaLifeSEXP, SEXP dRegLambdaTransSEXP, SEXP dNumObservationsSEXP, SEXP vRegIndexLifeSEXP, SEXP vRegIndexTransSEXP, SEXP iCorIndexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type kernel(kernelSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParamIndex(vParamIndexSEXP);
+    Rcpp::traits::input_parameter< const bool >::type bUseReg(bUseRegSEXP);
+    Rcpp::traits::input_parameter< const double >::type dRegLambdaLife(dRegLambdaLifeSEXP);
+    Rcpp::traits::input_parameter< const double >::type dRegLambdaTrans(dRegLambdaTransSEXP);
+    Rcpp::traits::input_parameter< const double >::type dNumObservations(dNumObservationsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vRegIndexLife(vRegIndexLifeSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vRegIndexTrans(vRegIndexTransSEXP);
+    Rcpp::traits::input_parameter< const int >::type iCorIndex(iCorIndexSEXP);
+    rcpp_result_gen = Rcpp::wrap(clv_objective_new(kernel, vX, vT_x, vT_cal, vWeights, ptrCovCache, vParamIndex, bUseReg, dRegLambdaLife, dRegLambdaTrans, dNumObservations, vRegIndexLife, vRegIndexTrans, iCorIndex));
+    return rcpp_result_gen;
+END_RCPP
+}
+// clv_objective_eval
+double clv_objective_eval(const arma::vec& vParams, SEXP ptrObjective, const bool bCheckParamMBounds);
+RcppExport SEXP _CLVTools_clv_objective_eval(SEXP vParamsSEXP, SEXP ptrObjectiveSEXP, SEXP bCheckParamMBoundsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrObjective(ptrObjectiveSEXP);
+    Rcpp::traits::input_parameter< const bool >::type bCheckParamMBounds(bCheckParamMBoundsSEXP);
+    rcpp_result_gen = Rcpp::wrap(clv_objective_eval(vParams, ptrObjective, bCheckParamMBounds));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_nocov_LL_scores
+arma::mat pnbd_nocov_LL_scores(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
+RcppExport SEXP _CLVTools_pnbd_nocov_LL_scores(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vLogparams(vLogparamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_nocov_LL_scores(vLogparams, vX, vT_x, vT_cal));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_nocov_LL_meat
+arma::mat pnbd_nocov_LL_meat(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads);
+RcppExport SEXP _CLVTools_pnbd_nocov_LL_meat(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vWeightsSEXP, SEXP vClusterSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vLogparams(vLogparamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vCluster(vClusterSEXP);
+    Rcpp::traits::input_parameter< const int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_nocov_LL_meat(vLogparams, vX, vT_x, vT_cal, vWeights, vCluster, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_staticcov_LL_scores
+arma::mat pnbd_staticcov_LL_scores(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP mCov_life, SEXP mCov_trans);
+RcppExport SEXP _CLVTools_pnbd_staticcov_LL_scores(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_LL_scores(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_staticcov_LL_meat
+arma::mat pnbd_staticcov_LL_meat(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP mCov_life, SEXP mCov_trans, const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads);
+RcppExport SEXP _CLVTools_pnbd_staticcov_LL_meat(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP, SEXP vClusterSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vCluster(vClusterSEXP);
+    Rcpp::traits::input_parameter< const int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_LL_meat(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights, vCluster, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_nocov_LL_scores
+arma::mat bgnbd_nocov_LL_scores(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
+RcppExport SEXP _CLVTools_bgnbd_nocov_LL_scores(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vLogparams(vLogparamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_nocov_LL_scores(vLogparams, vX, vT_x, vT_cal));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_nocov_LL_meat
+arma::mat bgnbd_nocov_LL_meat(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads);
+RcppExport SEXP _CLVTools_bgnbd_nocov_LL_meat(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vWeightsSEXP, SEXP vClusterSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vLogparams(vLogparamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vCluster(vClusterSEXP);
+    Rcpp::traits::input_parameter< const int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_nocov_LL_meat(vLogparams, vX, vT_x, vT_cal, vWeights, vCluster, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_staticcov_LL_scores
+arma::mat bgnbd_staticcov_LL_scores(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP mCov_life, SEXP mCov_trans);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_LL_scores(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_LL_scores(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bgnbd_staticcov_LL_meat
+arma::mat bgnbd_staticcov_LL_meat(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP mCov_life, SEXP mCov_trans, const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads);
+RcppExport SEXP _CLVTools_bgnbd_staticcov_LL_meat(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP, SEXP vClusterSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vCluster(vClusterSEXP);
+    Rcpp::traits::input_parameter< const int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(bgnbd_staticcov_LL_meat(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights, vCluster, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// clv_simulate
+Rcpp::List clv_simulate(const std::string& model, const arma::vec& vModelParams, const arma::vec& vSpendingParams, const int n, const double dAcquisitionPeriods, const double dObservationPeriods, const arma::mat& mCov_life, const arma::mat& mCov_trans, const arma::vec& vCovParams_life, const arma::vec& vCovParams_trans, const int seed, const int num_threads);
+RcppExport SEXP _CLVTools_clv_simulate(SEXP modelSEXP, SEXP vModelParamsSEXP, SEXP vSpendingParamsSEXP, SEXP nSEXP, SEXP dAcquisitionPeriodsSEXP, SEXP dObservationPeriodsSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vCovParams_lifeSEXP, SEXP vCovParams_transSEXP, SEXP seedSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vModelParams(vModelParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vSpendingParams(vSpendingParamsSEXP);
+    Rcpp::traits::input_parameter< const int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< const double >::type dAcquisitionPeriods(dAcquisitionPeriodsSEXP);
+    Rcpp::traits::input_parameter< const double >::type dObservationPeriods(dObservationPeriodsSEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
+    Rcpp::traits::input_parameter< const int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< const int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(clv_simulate(model, vModelParams, vSpendingParams, n, dAcquisitionPeriods, dObservationPeriods, mCov_life, mCov_trans, vCovParams_life, vCovParams_trans, seed, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // vec_gsl_hyp2f0_e
 Rcpp::List vec_gsl_hyp2f0_e(const RcppGSL::Vector& vA, const RcppGSL::Vector& vB, const RcppGSL::Vector& vZ);
 RcppExport SEXP _CLVTools_vec_gsl_hyp2f0_e(SEXP vASEXP, SEXP vBSEXP, SEXP vZSEXP) {
@@ -205,7 +476,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // ggomnbd_staticcov_CET
-arma::vec ggomnbd_staticcov_CET(const double r, const double alpha_0, const double b, const double s, const double beta_0, const double dPeriods, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_life, const arma::mat& mCov_trans);
+arma::vec ggomnbd_staticcov_CET(const double r, const double alpha_0, const double b, const double s, const double beta_0, const double dPeriods, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_life, SEXP mCov_trans);
 RcppExport SEXP _CLVTools_ggomnbd_staticcov_CET(SEXP rSEXP, SEXP alpha_0SEXP, SEXP bSEXP, SEXP sSEXP, SEXP beta_0SEXP, SEXP dPeriodsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -221,8 +492,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
     rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_CET(r, alpha_0, b, s, beta_0, dPeriods, vX, vT_x, vT_cal, vCovParams_trans, vCovParams_life, mCov_life, mCov_trans));
     return rcpp_result_gen;
 END_RCPP
@@ -242,8 +513,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // ggomnbd_nocov_LL_sum
-double ggomnbd_nocov_LL_sum(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
-RcppExport SEXP _CLVTools_ggomnbd_nocov_LL_sum(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP) {
+double ggomnbd_nocov_LL_sum(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_ggomnbd_nocov_LL_sum(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vWeightsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -251,7 +522,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
-    rcpp_result_gen = Rcpp::wrap(ggomnbd_nocov_LL_sum(vLogparams, vX, vT_x, vT_cal));
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ggomnbd_nocov_LL_sum(vLogparams, vX, vT_x, vT_cal, vWeights));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -272,8 +544,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // ggomnbd_staticcov_LL_sum
-double ggomnbd_staticcov_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans);
-RcppExport SEXP _CLVTools_ggomnbd_staticcov_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+double ggomnbd_staticcov_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_ggomnbd_staticcov_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -283,12 +555,77 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
     Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ggomnbd_staticcov_sparse_LL_ind
+arma::vec ggomnbd_staticcov_sparse_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::sp_mat& mCov_life, const arma::sp_mat& mCov_trans);
+RcppExport SEXP _CLVTools_ggomnbd_staticcov_sparse_LL_ind(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_trans(mCov_transSEXP);
+    rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_sparse_LL_ind(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ggomnbd_staticcov_sparse_LL_sum
+double ggomnbd_staticcov_sparse_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::sp_mat& mCov_life, const arma::sp_mat& mCov_trans, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_ggomnbd_staticcov_sparse_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_sparse_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ggomnbd_staticcov_cached_LL_ind
+arma::vec ggomnbd_staticcov_cached_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache);
+RcppExport SEXP _CLVTools_ggomnbd_staticcov_cached_LL_ind(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP ptrCovCacheSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_cached_LL_ind(vParams, vX, vT_x, vT_cal, ptrCovCache));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ggomnbd_staticcov_cached_LL_sum
+double ggomnbd_staticcov_cached_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_ggomnbd_staticcov_cached_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP ptrCovCacheSEXP, SEXP vWeightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_cached_LL_sum(vParams, vX, vT_x, vT_cal, ptrCovCache, vWeights));
     return rcpp_result_gen;
 END_RCPP
 }
 // ggomnbd_staticcov_PAlive
-arma::vec ggomnbd_staticcov_PAlive(const double r, const double alpha_0, const double b, const double s, const double beta_0, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_life, const arma::mat& mCov_trans);
+arma::vec ggomnbd_staticcov_PAlive(const double r, const double alpha_0, const double b, const double s, const double beta_0, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_life, SEXP mCov_trans);
 RcppExport SEXP _CLVTools_ggomnbd_staticcov_PAlive(SEXP rSEXP, SEXP alpha_0SEXP, SEXP bSEXP, SEXP sSEXP, SEXP beta_0SEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -303,8 +640,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
     rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_PAlive(r, alpha_0, b, s, beta_0, vX, vT_x, vT_cal, vCovParams_trans, vCovParams_life, mCov_life, mCov_trans));
     return rcpp_result_gen;
 END_RCPP
@@ -344,7 +681,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // ggomnbd_staticcov_expectation
-arma::vec ggomnbd_staticcov_expectation(const double r, const double alpha_0, const double b, const double s, const double beta_0, const arma::vec& vT_i, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_life, const arma::mat& mCov_trans);
+arma::vec ggomnbd_staticcov_expectation(const double r, const double alpha_0, const double b, const double s, const double beta_0, const arma::vec& vT_i, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_life, SEXP mCov_trans);
 RcppExport SEXP _CLVTools_ggomnbd_staticcov_expectation(SEXP rSEXP, SEXP alpha_0SEXP, SEXP bSEXP, SEXP sSEXP, SEXP beta_0SEXP, SEXP vT_iSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -357,8 +694,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_i(vT_iSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
     rcpp_result_gen = Rcpp::wrap(ggomnbd_staticcov_expectation(r, alpha_0, b, s, beta_0, vT_i, vCovParams_trans, vCovParams_life, mCov_life, mCov_trans));
     return rcpp_result_gen;
 END_RCPP
@@ -382,7 +719,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // pnbd_staticcov_CET
-arma::vec pnbd_staticcov_CET(const double r, const double alpha_0, const double s, const double beta_0, const double dPeriods, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_trans, const arma::mat& mCov_life);
+arma::vec pnbd_staticcov_CET(const double r, const double alpha_0, const double s, const double beta_0, const double dPeriods, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_trans, SEXP mCov_life);
 RcppExport SEXP _CLVTools_pnbd_staticcov_CET(SEXP rSEXP, SEXP alpha_0SEXP, SEXP sSEXP, SEXP beta_0SEXP, SEXP dPeriodsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_transSEXP, SEXP mCov_lifeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -397,8 +734,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
     rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_CET(r, alpha_0, s, beta_0, dPeriods, vX, vT_x, vT_cal, vCovParams_trans, vCovParams_life, mCov_trans, mCov_life));
     return rcpp_result_gen;
 END_RCPP
@@ -422,7 +759,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // pnbd_staticcov_DERT
-arma::vec pnbd_staticcov_DERT(const double r, const double alpha_0, const double s, const double beta_0, const double continuous_discount_factor, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans, const arma::vec& vCovParams_life, const arma::vec& vCovParams_trans);
+arma::vec pnbd_staticcov_DERT(const double r, const double alpha_0, const double s, const double beta_0, const double continuous_discount_factor, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP mCov_life, SEXP mCov_trans, const arma::vec& vCovParams_life, const arma::vec& vCovParams_trans);
 RcppExport SEXP _CLVTools_pnbd_staticcov_DERT(SEXP rSEXP, SEXP alpha_0SEXP, SEXP sSEXP, SEXP beta_0SEXP, SEXP continuous_discount_factorSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vCovParams_lifeSEXP, SEXP vCovParams_transSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -435,8 +772,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_DERT(r, alpha_0, s, beta_0, continuous_discount_factor, vX, vT_x, vT_cal, mCov_life, mCov_trans, vCovParams_life, vCovParams_trans));
@@ -458,8 +795,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // pnbd_nocov_LL_sum
-double pnbd_nocov_LL_sum(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
-RcppExport SEXP _CLVTools_pnbd_nocov_LL_sum(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP) {
+double pnbd_nocov_LL_sum(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_pnbd_nocov_LL_sum(SEXP vLogparamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vWeightsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -467,7 +804,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
-    rcpp_result_gen = Rcpp::wrap(pnbd_nocov_LL_sum(vLogparams, vX, vT_x, vT_cal));
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_nocov_LL_sum(vLogparams, vX, vT_x, vT_cal, vWeights));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -488,8 +826,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // pnbd_staticcov_LL_sum
-double pnbd_staticcov_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans);
-RcppExport SEXP _CLVTools_pnbd_staticcov_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+double pnbd_staticcov_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::mat& mCov_life, const arma::mat& mCov_trans, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_pnbd_staticcov_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -499,7 +837,72 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
     Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_staticcov_sparse_LL_ind
+arma::vec pnbd_staticcov_sparse_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::sp_mat& mCov_life, const arma::sp_mat& mCov_trans);
+RcppExport SEXP _CLVTools_pnbd_staticcov_sparse_LL_ind(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_trans(mCov_transSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_sparse_LL_ind(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_staticcov_sparse_LL_sum
+double pnbd_staticcov_sparse_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::sp_mat& mCov_life, const arma::sp_mat& mCov_trans, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_pnbd_staticcov_sparse_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP mCov_lifeSEXP, SEXP mCov_transSEXP, SEXP vWeightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_sparse_LL_sum(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans, vWeights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_staticcov_cached_LL_ind
+arma::vec pnbd_staticcov_cached_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache);
+RcppExport SEXP _CLVTools_pnbd_staticcov_cached_LL_ind(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP ptrCovCacheSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_cached_LL_ind(vParams, vX, vT_x, vT_cal, ptrCovCache));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pnbd_staticcov_cached_LL_sum
+double pnbd_staticcov_cached_LL_sum(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache, const arma::vec& vWeights);
+RcppExport SEXP _CLVTools_pnbd_staticcov_cached_LL_sum(SEXP vParamsSEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP ptrCovCacheSEXP, SEXP vWeightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type vParams(vParamsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vX(vXSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_x(vT_xSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type ptrCovCache(ptrCovCacheSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type vWeights(vWeightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_cached_LL_sum(vParams, vX, vT_x, vT_cal, ptrCovCache, vWeights));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -521,7 +924,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // pnbd_staticcov_PAlive
-arma::vec pnbd_staticcov_PAlive(const double r, const double alpha_0, const double s, const double beta_0, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, const arma::mat& mCov_trans, const arma::mat& mCov_life);
+arma::vec pnbd_staticcov_PAlive(const double r, const double alpha_0, const double s, const double beta_0, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const arma::vec& vCovParams_trans, const arma::vec& vCovParams_life, SEXP mCov_trans, SEXP mCov_life);
 RcppExport SEXP _CLVTools_pnbd_staticcov_PAlive(SEXP rSEXP, SEXP alpha_0SEXP, SEXP sSEXP, SEXP beta_0SEXP, SEXP vXSEXP, SEXP vT_xSEXP, SEXP vT_calSEXP, SEXP vCovParams_transSEXP, SEXP vCovParams_lifeSEXP, SEXP mCov_transSEXP, SEXP mCov_lifeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -535,8 +938,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const arma::vec& >::type vT_cal(vT_calSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_trans(vCovParams_transSEXP);
     Rcpp::traits::input_parameter< const arma::vec& >::type vCovParams_life(vCovParams_lifeSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_trans(mCov_transSEXP);
-    Rcpp::traits::input_parameter< const arma::mat& >::type mCov_life(mCov_lifeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_trans(mCov_transSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mCov_life(mCov_lifeSEXP);
     rcpp_result_gen = Rcpp::wrap(pnbd_staticcov_PAlive(r, alpha_0, s, beta_0, vX, vT_x, vT_cal, vCovParams_trans, vCovParams_life, mCov_trans, mCov_life));
     return rcpp_result_gen;
 END_RCPP
@@ -546,20 +949,40 @@ static const R_CallMethodDef CallEntries[] = {
     {"_CLVTools_bgnbd_nocov_CET", (DL_FUNC) &_CLVTools_bgnbd_nocov_CET, 8},
     {"_CLVTools_bgnbd_staticcov_CET", (DL_FUNC) &_CLVTools_bgnbd_staticcov_CET, 12},
     {"_CLVTools_bgnbd_nocov_LL_ind", (DL_FUNC) &_CLVTools_bgnbd_nocov_LL_ind, 4},
-    {"_CLVTools_bgnbd_nocov_LL_sum", (DL_FUNC) &_CLVTools_bgnbd_nocov_LL_sum, 4},
+    {"_CLVTools_bgnbd_nocov_LL_sum", (DL_FUNC) &_CLVTools_bgnbd_nocov_LL_sum, 5},
     {"_CLVTools_bgnbd_staticcov_LL_ind", (DL_FUNC) &_CLVTools_bgnbd_staticcov_LL_ind, 6},
-    {"_CLVTools_bgnbd_staticcov_LL_sum", (DL_FUNC) &_CLVTools_bgnbd_staticcov_LL_sum, 6},
+    {"_CLVTools_bgnbd_staticcov_LL_sum", (DL_FUNC) &_CLVTools_bgnbd_staticcov_LL_sum, 7},
+    {"_CLVTools_bgnbd_staticcov_sparse_LL_ind", (DL_FUNC) &_CLVTools_bgnbd_staticcov_sparse_LL_ind, 6},
+    {"_CLVTools_bgnbd_staticcov_sparse_LL_sum", (DL_FUNC) &_CLVTools_bgnbd_staticcov_sparse_LL_sum, 7},
+    {"_CLVTools_bgnbd_staticcov_cached_LL_ind", (DL_FUNC) &_CLVTools_bgnbd_staticcov_cached_LL_ind, 5},
+    {"_CLVTools_bgnbd_staticcov_cached_LL_sum", (DL_FUNC) &_CLVTools_bgnbd_staticcov_cached_LL_sum, 6},
     {"_CLVTools_bgnbd_nocov_PAlive", (DL_FUNC) &_CLVTools_bgnbd_nocov_PAlive, 7},
     {"_CLVTools_bgnbd_staticcov_PAlive", (DL_FUNC) &_CLVTools_bgnbd_staticcov_PAlive, 11},
+    {"_CLVTools_clv_staticcov_cache_new", (DL_FUNC) &_CLVTools_clv_staticcov_cache_new, 4},
+    {"_CLVTools_clv_objective_new", (DL_FUNC) &_CLVTools_clv_objective_new, 14},
+    {"_CLVTools_clv_objective_eval", (DL_FUNC) &_CLVTools_clv_objective_eval, 3},
+    {"_CLVTools_pnbd_nocov_LL_scores", (DL_FUNC) &_CLVTools_pnbd_nocov_LL_scores, 4},
+    {"_CLVTools_pnbd_nocov_LL_meat", (DL_FUNC) &_CLVTools_pnbd_nocov_LL_meat, 7},
+    {"_CLVTools_pnbd_staticcov_LL_scores", (DL_FUNC) &_CLVTools_pnbd_staticcov_LL_scores, 6},
+    {"_CLVTools_pnbd_staticcov_LL_meat", (DL_FUNC) &_CLVTools_pnbd_staticcov_LL_meat, 9},
+    {"_CLVTools_bgnbd_nocov_LL_scores", (DL_FUNC) &_CLVTools_bgnbd_nocov_LL_scores, 4},
+    {"_CLVTools_bgnbd_nocov_LL_meat", (DL_FUNC) &_CLVTools_bgnbd_nocov_LL_meat, 7},
+    {"_CLVTools_bgnbd_staticcov_LL_scores", (DL_FUNC) &_CLVTools_bgnbd_staticcov_LL_scores, 6},
+    {"_CLVTools_bgnbd_staticcov_LL_meat", (DL_FUNC) &_CLVTools_bgnbd_staticcov_LL_meat, 9},
+    {"_CLVTools_clv_simulate", (DL_FUNC) &_CLVTools_clv_simulate, 12},
     {"_CLVTools_vec_gsl_hyp2f0_e", (DL_FUNC) &_CLVTools_vec_gsl_hyp2f0_e, 3},
     {"_CLVTools_vec_gsl_hyp2f1_e", (DL_FUNC) &_CLVTools_vec_gsl_hyp2f1_e, 4},
     {"_CLVTools_gg_LL", (DL_FUNC) &_CLVTools_gg_LL, 3},
     {"_CLVTools_ggomnbd_nocov_CET", (DL_FUNC) &_CLVTools_ggomnbd_nocov_CET, 9},
     {"_CLVTools_ggomnbd_staticcov_CET", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_CET, 13},
     {"_CLVTools_ggomnbd_nocov_LL_ind", (DL_FUNC) &_CLVTools_ggomnbd_nocov_LL_ind, 4},
-    {"_CLVTools_ggomnbd_nocov_LL_sum", (DL_FUNC) &_CLVTools_ggomnbd_nocov_LL_sum, 4},
+    {"_CLVTools_ggomnbd_nocov_LL_sum", (DL_FUNC) &_CLVTools_ggomnbd_nocov_LL_sum, 5},
     {"_CLVTools_ggomnbd_staticcov_LL_ind", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_LL_ind, 6},
-    {"_CLVTools_ggomnbd_staticcov_LL_sum", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_LL_sum, 6},
+    {"_CLVTools_ggomnbd_staticcov_LL_sum", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_LL_sum, 7},
+    {"_CLVTools_ggomnbd_staticcov_sparse_LL_ind", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_sparse_LL_ind, 6},
+    {"_CLVTools_ggomnbd_staticcov_sparse_LL_sum", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_sparse_LL_sum, 7},
+    {"_CLVTools_ggomnbd_staticcov_cached_LL_ind", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_cached_LL_ind, 5},
+    {"_CLVTools_ggomnbd_staticcov_cached_LL_sum", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_cached_LL_sum, 6},
     {"_CLVTools_ggomnbd_staticcov_PAlive", (DL_FUNC) &_CLVTools_ggomnbd_staticcov_PAlive, 12},
     {"_CLVTools_ggomnbd_nocov_PAlive", (DL_FUNC) &_CLVTools_ggomnbd_nocov_PAlive, 8},
     {"_CLVTools_ggomnbd_nocov_expectation", (DL_FUNC) &_CLVTools_ggomnbd_nocov_expectation, 6},
@@ -569,9 +992,13 @@ static const R_CallMethodDef CallEntries[] = {
     {"_CLVTools_pnbd_nocov_DERT", (DL_FUNC) &_CLVTools_pnbd_nocov_DERT, 8},
     {"_CLVTools_pnbd_staticcov_DERT", (DL_FUNC) &_CLVTools_pnbd_staticcov_DERT, 12},
     {"_CLVTools_pnbd_nocov_LL_ind", (DL_FUNC) &_CLVTools_pnbd_nocov_LL_ind, 4},
-    {"_CLVTools_pnbd_nocov_LL_sum", (DL_FUNC) &_CLVTools_pnbd_nocov_LL_sum, 4},
+    {"_CLVTools_pnbd_nocov_LL_sum", (DL_FUNC) &_CLVTools_pnbd_nocov_LL_sum, 5},
     {"_CLVTools_pnbd_staticcov_LL_ind", (DL_FUNC) &_CLVTools_pnbd_staticcov_LL_ind, 6},
-    {"_CLVTools_pnbd_staticcov_LL_sum", (DL_FUNC) &_CLVTools_pnbd_staticcov_LL_sum, 6},
+    {"_CLVTools_pnbd_staticcov_LL_sum", (DL_FUNC) &_CLVTools_pnbd_staticcov_LL_sum, 7},
+    {"_CLVTools_pnbd_staticcov_sparse_LL_ind", (DL_FUNC) &_CLVTools_pnbd_staticcov_sparse_LL_ind, 6},
+    {"_CLVTools_pnbd_staticcov_sparse_LL_sum", (DL_FUNC) &_CLVTools_pnbd_staticcov_sparse_LL_sum, 7},
+    {"_CLVTools_pnbd_staticcov_cached_LL_ind", (DL_FUNC) &_CLVTools_pnbd_staticcov_cached_LL_ind, 5},
+    {"_CLVTools_pnbd_staticcov_cached_LL_sum", (DL_FUNC) &_CLVTools_pnbd_staticcov_cached_LL_sum, 6},
     {"_CLVTools_pnbd_nocov_PAlive", (DL_FUNC) &_CLVTools_pnbd_nocov_PAlive, 7},
     {"_CLVTools_pnbd_staticcov_PAlive", (DL_FUNC) &_CLVTools_pnbd_staticcov_PAlive, 11},
     {NULL, NULL, 0}
@@ -1,6 +1,8 @@
 #include <RcppArmadillo.h>
 #include <math.h>
-#include "clv_vectorized.h"
+#include "core/bgnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name bgnbd_CET
 //'
@@ -18,26 +20,10 @@
 //' @templateVar name_params_cov_trans vCovParams_trans
 //' @template template_details_rcppcovmatrix
 //'
+//' @details Both may also be sparse matrices of class \code{dgCMatrix}.
+//'
 //' @template template_references_bgnbd
 //'
-arma::vec bgnbd_CET(const double r,
-                    const arma::vec& vAlpha_i,
-                    const arma::vec& vA_i,
-                    const arma::vec& vB_i,
-                    const double dPeriods,
-                    const arma::vec& vX,
-                    const arma::vec& vT_x,
-                    const arma::vec& vT_cal){
-  arma::vec term1 = ((vA_i + vB_i + vX - 1) / (vA_i - 1));
-
-  arma::vec term2 = 1 - clv::vec_pow((vAlpha_i + vT_cal)/(vAlpha_i + vT_cal + dPeriods), (r + vX)) % clv::vec_hyp2F1((r + vX), (vB_i + vX), (vA_i + vB_i + vX - 1), dPeriods / (vAlpha_i + vT_cal + dPeriods));
-
-  arma::vec term3 = 1 + (vX > 0) % (vA_i /(vB_i + vX - 1)) % clv::vec_pow((vAlpha_i + vT_cal)/(vAlpha_i + vT_x), (r + vX));
-
-  return term1 % term2 / term3;
-}
-
-//' @rdname bgnbd_CET
 // [[Rcpp::export]]
 arma::vec bgnbd_nocov_CET(const double r,
                     const double alpha,
@@ -58,7 +44,7 @@ arma::vec bgnbd_nocov_CET(const double r,
   vA_i.fill(a);
   vB_i.fill(b);
 
-  return bgnbd_CET(r, vAlpha_i, vA_i, vB_i, dPeriods, vX, vT_x, vT_cal);
+  return clv::bgnbd_CET(r, vAlpha_i, vA_i, vB_i, dPeriods, vX, vT_x, vT_cal);
 }
 
 //' @rdname bgnbd_CET
@@ -73,18 +59,20 @@ arma::vec bgnbd_staticcov_CET(const double r,
                               const arma::vec& vT_cal,
                               const arma::vec& vCovParams_trans,
                               const arma::vec& vCovParams_life,
-                              const arma::mat& mCov_trans,
-                              const arma::mat& mCov_life){
-
+                              SEXP mCov_trans,
+                              SEXP mCov_life){
+  // Dense matrices or dgCMatrix
+  const clv::CovLinPred cov_trans = clv::cov_lin_pred(mCov_trans);
+  const clv::CovLinPred cov_life  = clv::cov_lin_pred(mCov_life);
 
-  if(vCovParams_trans.n_elem != mCov_trans.n_cols)
+  if(vCovParams_trans.n_elem != cov_trans.n_cols)
     throw std::out_of_range("Vector of transaction parameters need to have same length as number of columns in transaction covariates!");
 
-  if(vCovParams_life.n_elem != mCov_life.n_cols)
+  if(vCovParams_life.n_elem != cov_life.n_cols)
     throw std::out_of_range("Vector of lifetime parameters need to have same length as number of columns in lifetime covariates!");
 
-  if((vX.n_elem != mCov_trans.n_rows) ||
-     (vX.n_elem != mCov_life.n_rows))
+  if((vX.n_elem != cov_trans.n_rows) ||
+     (vX.n_elem != cov_life.n_rows))
     throw std::out_of_range("There need to be as many covariate rows as customers!");
 
 
@@ -95,9 +83,9 @@ arma::vec bgnbd_staticcov_CET(const double r,
 
   arma::vec vAlpha_i(n), vA_i(n), vB_i(n);
 
-  vAlpha_i = alpha * arma::exp(((mCov_trans * (-1)) * vCovParams_trans));
-  vA_i     = a     * arma::exp((mCov_life           * vCovParams_life));
-  vB_i     = b     * arma::exp((mCov_life           * vCovParams_life));
+  vAlpha_i = clv::vec_exp_cov(alpha, cov_trans, vCovParams_trans, -1);
+  vA_i     = clv::vec_exp_cov(a, cov_life, vCovParams_life, 1);
+  vB_i     = clv::vec_exp_cov(b, cov_life, vCovParams_life, 1);
 
-  return bgnbd_CET(r, vAlpha_i, vA_i, vB_i, dPeriods, vX, vT_x, vT_cal);
+  return clv::bgnbd_CET(r, vAlpha_i, vA_i, vB_i, dPeriods, vX, vT_x, vT_cal);
 }
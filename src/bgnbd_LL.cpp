@@ -1,9 +1,8 @@
 #include <RcppArmadillo.h>
 #include <math.h>
-#include "clv_vectorized.h"
-
-arma::vec beta_ratio(const arma::vec& a, const arma::vec& b, const arma::vec& x, const arma::vec& y);
-
+#include "core/bgnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name bgnbd_LL
 //'
@@ -21,27 +20,6 @@ arma::vec beta_ratio(const arma::vec& a, const arma::vec& b, const arma::vec& x,
 //'
 //' @template template_references_bgnbd
 //'
-arma::vec bgnbd_LL_ind(const double r,
-                       const arma::vec& vAlpha_i,
-                       const arma::vec& vA_i,
-                       const arma::vec& vB_i,
-                       const arma::vec& vX,
-                       const arma::vec& vT_x,
-                       const arma::vec& vT_cal){
-  const unsigned int n = vX.n_elem;
-
-  arma::vec vA(n), vB(n), vBetaRatio(n);
-
-  vA = r * arma::log(vAlpha_i) + arma::lgamma(r + vX) - std::lgamma(r) - (r + vX) % arma::log(vAlpha_i + vT_x);
-
-  vB = beta_ratio(vA_i, (vB_i+vX), vA_i, vB_i) % clv::vec_pow((vAlpha_i + vT_x)/(vAlpha_i + vT_cal), (r + vX)) + ((vX > 0)) % beta_ratio(vA_i + 1 , (vB_i + vX - 1), vA_i, vB_i);
-
-  arma::vec vLL = vA + arma::log(vB);
-
-  return(vLL);
-}
-
-//' @rdname bgnbd_LL
 // [[Rcpp::export]]
 arma::vec bgnbd_nocov_LL_ind(const arma::vec& vLogparams,
                             const arma::vec& vX,
@@ -61,7 +39,7 @@ arma::vec bgnbd_nocov_LL_ind(const arma::vec& vLogparams,
   vA_i.fill(a_0);
   vB_i.fill(b_0);
 
-  arma::vec vLL = bgnbd_LL_ind(r, vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal);
+  arma::vec vLL = clv::bgnbd_LL_ind(r, vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal);
 
   return(vLL);
 }
@@ -72,24 +50,25 @@ arma::vec bgnbd_nocov_LL_ind(const arma::vec& vLogparams,
 double bgnbd_nocov_LL_sum(const arma::vec& vLogparams,
                           const arma::vec& vX,
                           const arma::vec& vT_x,
-                          const arma::vec& vT_cal){
+                          const arma::vec& vT_cal,
+                          const arma::vec& vWeights){
 
   arma::vec vLL = bgnbd_nocov_LL_ind(vLogparams,
                                     vX,
                                     vT_x,
                                     vT_cal);
 
-  return(-arma::sum(vLL));
+  return(clv::neg_sum_weighted(vLL, vWeights));
 }
 
-//' @rdname bgnbd_LL
-// [[Rcpp::export]]
-arma::vec bgnbd_staticcov_LL_ind(const arma::vec& vParams,
-                                 const arma::vec& vX,
-                                 const arma::vec& vT_x,
-                                 const arma::vec& vT_cal,
-                                 const arma::mat& mCov_life,
-                                 const arma::mat& mCov_trans){
+// Static covariates, dense (arma::mat) or sparse (arma::sp_mat) covariate data
+template<typename TMat>
+arma::vec bgnbd_staticcov_LL_ind_cov(const arma::vec& vParams,
+                                     const arma::vec& vX,
+                                     const arma::vec& vT_x,
+                                     const arma::vec& vT_cal,
+                                     const TMat& mCov_life,
+                                     const TMat& mCov_trans){
   const double no_cov_life  = mCov_life.n_cols;
   const double no_cov_trans = mCov_trans.n_cols;
 
@@ -102,8 +81,6 @@ arma::vec bgnbd_staticcov_LL_ind(const arma::vec& vParams,
   const double a_0      = exp(vModel_log_params(2));
   const double b_0      = exp(vModel_log_params(3));
 
-  const double n = vX.n_elem;
-
 
 
   // Build alpha, a and b --------------------------------------------
@@ -112,19 +89,28 @@ arma::vec bgnbd_staticcov_LL_ind(const arma::vec& vParams,
   //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
   //    a_i:  a0 * exp(cov.life * cov.param.life)
   //    b_i:  b0 * exp(cov.life * cov.param.life)
-  arma::vec vAlpha_i(n), vA_i(n), vB_i(n);
-
-  vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vTrans_params));
-  vA_i     = a_0     * arma::exp(((mCov_life          * vLife_params)));
-  vB_i     = b_0     * arma::exp(((mCov_life          * vLife_params)));
+  const arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, mCov_trans, vTrans_params, -1);
+  const arma::vec vA_i     = clv::vec_exp_cov(a_0,     mCov_life,  vLife_params,   1);
+  const arma::vec vB_i     = vA_i * (b_0 / a_0);
 
   // Calculate LL ----------------------------------------------------
   //    Calculate value for every customer
-  arma::vec vLL = bgnbd_LL_ind(r, vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal);
+  arma::vec vLL = clv::bgnbd_LL_ind(r, vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal);
 
   return(vLL);
 }
 
+//' @rdname bgnbd_LL
+// [[Rcpp::export]]
+arma::vec bgnbd_staticcov_LL_ind(const arma::vec& vParams,
+                                 const arma::vec& vX,
+                                 const arma::vec& vT_x,
+                                 const arma::vec& vT_cal,
+                                 const arma::mat& mCov_life,
+                                 const arma::mat& mCov_trans){
+  return(bgnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+}
+
 //' @rdname bgnbd_LL
 // [[Rcpp::export]]
 double bgnbd_staticcov_LL_sum(const arma::vec& vParams,
@@ -132,19 +118,71 @@ double bgnbd_staticcov_LL_sum(const arma::vec& vParams,
                               const arma::vec& vT_x,
                               const arma::vec& vT_cal,
                               const arma::mat& mCov_life,
-                              const arma::mat& mCov_trans){
-  arma::vec vLL = bgnbd_staticcov_LL_ind(vParams,
-                                         vX,
-                                         vT_x,
-                                         vT_cal,
-                                         mCov_life,
-                                         mCov_trans);
-
-  return(-arma::sum(vLL));
+                              const arma::mat& mCov_trans,
+                              const arma::vec& vWeights){
+  arma::vec vLL = bgnbd_staticcov_LL_ind_cov(vParams,
+                                             vX,
+                                             vT_x,
+                                             vT_cal,
+                                             mCov_life,
+                                             mCov_trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
 }
 
-arma::vec beta_ratio(const arma::vec& a, const arma::vec& b, const arma::vec& x, const arma::vec& y){
-  return(arma::exp(arma::lgamma(a) + arma::lgamma(b) - arma::lgamma(a + b) - arma::lgamma(x) - arma::lgamma(y) + arma::lgamma(x+y)));
+//' @rdname bgnbd_LL
+// [[Rcpp::export]]
+arma::vec bgnbd_staticcov_sparse_LL_ind(const arma::vec& vParams,
+                                        const arma::vec& vX,
+                                        const arma::vec& vT_x,
+                                        const arma::vec& vT_cal,
+                                        const arma::sp_mat& mCov_life,
+                                        const arma::sp_mat& mCov_trans){
+  return(bgnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
 }
 
+//' @rdname bgnbd_LL
+// [[Rcpp::export]]
+double bgnbd_staticcov_sparse_LL_sum(const arma::vec& vParams,
+                                     const arma::vec& vX,
+                                     const arma::vec& vT_x,
+                                     const arma::vec& vT_cal,
+                                     const arma::sp_mat& mCov_life,
+                                     const arma::sp_mat& mCov_trans,
+                                     const arma::vec& vWeights){
+  arma::vec vLL = bgnbd_staticcov_LL_ind_cov(vParams,
+                                             vX,
+                                             vT_x,
+                                             vT_cal,
+                                             mCov_life,
+                                             mCov_trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
+}
+
+
+//' @rdname bgnbd_LL
+// [[Rcpp::export]]
+arma::vec bgnbd_staticcov_cached_LL_ind(const arma::vec& vParams,
+                                        const arma::vec& vX,
+                                        const arma::vec& vT_x,
+                                        const arma::vec& vT_cal,
+                                        SEXP ptrCovCache){
+  const clv::StaticCovCache& cov_cache = clv::staticcov_cache(ptrCovCache);
+  return(bgnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, cov_cache.life, cov_cache.trans));
+}
+
+//' @rdname bgnbd_LL
+// [[Rcpp::export]]
+double bgnbd_staticcov_cached_LL_sum(const arma::vec& vParams,
+                                     const arma::vec& vX,
+                                     const arma::vec& vT_x,
+                                     const arma::vec& vT_cal,
+                                     SEXP ptrCovCache,
+                                     const arma::vec& vWeights){
+  const clv::StaticCovCache& cov_cache = clv::staticcov_cache(ptrCovCache);
+  const arma::vec vLL = bgnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, cov_cache.life, cov_cache.trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
+}
 
@@ -0,0 +1,119 @@
+#include <RcppArmadillo.h>
+#include "clv_covcache.h"
+
+namespace clv{
+
+// Recalculate the full linear predictors after this many column updates to not accumulate rounding errors
+const unsigned int MAX_NUM_COLUMN_UPDATES = 100;
+
+CovLinPred::CovLinPred(const arma::mat& mCov_unique, const arma::uvec& uvPattern)
+  : uvPattern(uvPattern), n_rows(uvPattern.n_elem), n_cols(mCov_unique.n_cols), n_patterns(mCov_unique.n_rows),
+    is_sparse(false), mCov_dense(mCov_unique), mCov_sparse(),
+    vParams_cached(), vLinPred(), num_updates(0) {
+
+  if(uvPattern.n_elem > 0 && uvPattern.max() >= n_patterns)
+    throw std::out_of_range(std::string("The covariate pattern of every customer needs to be a row of the covariate data!"));
+}
+
+CovLinPred::CovLinPred(const arma::sp_mat& mCov_unique, const arma::uvec& uvPattern)
+  : uvPattern(uvPattern), n_rows(uvPattern.n_elem), n_cols(mCov_unique.n_cols), n_patterns(mCov_unique.n_rows),
+    is_sparse(true), mCov_dense(), mCov_sparse(mCov_unique),
+    vParams_cached(), vLinPred(), num_updates(0) {
+
+  if(uvPattern.n_elem > 0 && uvPattern.max() >= n_patterns)
+    throw std::out_of_range(std::string("The covariate pattern of every customer needs to be a row of the covariate data!"));
+}
+
+const arma::vec& CovLinPred::lin_pred(const arma::vec& vParams) const{
+
+  if(vParams.n_elem != n_cols)
+    throw std::runtime_error(std::string("There need to be as many covariate parameters as covariates!"));
+
+  // Nothing cached yet
+  if(vParams_cached.n_elem != n_cols){
+    vLinPred = is_sparse ? arma::vec(mCov_sparse * vParams) : arma::vec(mCov_dense * vParams);
+    vParams_cached = vParams;
+    num_updates = 0;
+    return(vLinPred);
+  }
+
+  const arma::uvec uvChanged = arma::find(vParams != vParams_cached);
+  if(uvChanged.n_elem == 0)
+    return(vLinPred);
+
+  // Only add the changed columns if these are few. Otherwise the full product is cheaper
+  if((uvChanged.n_elem * 4 <= n_cols) && (num_updates + uvChanged.n_elem <= MAX_NUM_COLUMN_UPDATES)){
+    for(arma::uword k = 0; k < uvChanged.n_elem; k++){
+      const arma::uword j     = uvChanged(k);
+      const double      delta = vParams(j) - vParams_cached(j);
+
+      if(is_sparse){
+        for(arma::sp_mat::const_col_iterator it = mCov_sparse.begin_col(j); it != mCov_sparse.end_col(j); ++it)
+          vLinPred(it.row()) += delta * (*it);
+      }else{
+        vLinPred += delta * mCov_dense.col(j);
+      }
+    }
+    num_updates += uvChanged.n_elem;
+  }else{
+    vLinPred = is_sparse ? arma::vec(mCov_sparse * vParams) : arma::vec(mCov_dense * vParams);
+    num_updates = 0;
+  }
+
+  vParams_cached = vParams;
+  return(vLinPred);
+}
+
+arma::vec vec_exp_cov(const double base, const CovLinPred& mCov, const arma::vec& vParams, const double sign){
+  const arma::vec vExpPattern = base * arma::exp(sign * mCov.lin_pred(vParams));
+  return(vExpPattern.elem(mCov.uvPattern));
+}
+
+// Dense matrix or dgCMatrix. Patterns are 0-based
+static CovLinPred cov_lin_pred(SEXP mCov, const arma::uvec& uvPattern){
+  if(Rf_isS4(mCov))
+    return(CovLinPred(Rcpp::as<arma::sp_mat>(mCov), uvPattern));
+  return(CovLinPred(Rcpp::as<arma::mat>(mCov), uvPattern));
+}
+
+// Every customer is its own pattern
+CovLinPred cov_lin_pred(SEXP mCov){
+  const arma::uword n = Rf_isS4(mCov) ? Rcpp::IntegerVector(Rcpp::S4(mCov).slot("Dim"))[0] : Rf_nrows(mCov);
+  arma::uvec uvPattern(n);
+  for(arma::uword i = 0; i < n; i++)
+    uvPattern(i) = i;
+  return(cov_lin_pred(mCov, uvPattern));
+}
+
+const StaticCovCache& staticcov_cache(SEXP ptrCovCache){
+  const Rcpp::XPtr<StaticCovCache> ptr(ptrCovCache);
+  // Pointers are NULL after the R session was restored
+  if(ptr.get() == NULL)
+    throw std::runtime_error(std::string("The covariate cache is not valid anymore!"));
+  return(*ptr);
+}
+
+}
+
+//' @title Cache of static covariate data
+//'
+//' @param mCov_life Matrix or sparse matrix (\code{dgCMatrix}) containing the distinct rows of the covariates data affecting the lifetime process.
+//' @param vPattern_life Row in \code{mCov_life} of every customer (1-based).
+//' @param mCov_trans Matrix or sparse matrix (\code{dgCMatrix}) containing the distinct rows of the covariates data affecting the transaction process.
+//' @param vPattern_trans Row in \code{mCov_trans} of every customer (1-based).
+//'
+//' @description Keeps the covariate data and the linear predictors of the last evaluated parameters
+//' between evaluations of the \code{_staticcov_cached_} LL functions. The linear predictors are only
+//' calculated for the distinct covariate rows. If only few covariate parameters
+//' changed since the last evaluation, only their columns are added to the linear predictors.
+//'
+//' @return External pointer to the cache.
+//' @keywords internal
+// [[Rcpp::export]]
+SEXP clv_staticcov_cache_new(SEXP mCov_life, const arma::uvec& vPattern_life,
+                             SEXP mCov_trans, const arma::uvec& vPattern_trans){
+  // Patterns are 1-based in R
+  Rcpp::XPtr<clv::StaticCovCache> ptr(new clv::StaticCovCache(clv::cov_lin_pred(mCov_life,  vPattern_life - 1),
+                                                              clv::cov_lin_pred(mCov_trans, vPattern_trans - 1)), true);
+  return(ptr);
+}
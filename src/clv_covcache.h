@@ -0,0 +1,61 @@
+#ifndef CLV_COVCACHE_HPP
+#define CLV_COVCACHE_HPP
+
+namespace clv{
+
+// CovLinPred
+//    Static covariate data (dense or sparse) and its linear predictors mCov * vParams of the params last evaluated.
+//    Only the distinct covariate rows (patterns) are kept, together with the pattern of every customer. Linear
+//    predictors are per pattern, of which there are usually far fewer than customers.
+//    If only few params changed since (ie in finite-difference gradients), only the columns of these params
+//    are added to the linear predictors. Only the non-zero entries of the columns if the data is sparse.
+class CovLinPred{
+public:
+  // mCov_unique: distinct covariate rows, uvPattern: row in mCov_unique of every customer (0-based)
+  CovLinPred(const arma::mat& mCov_unique, const arma::uvec& uvPattern);
+  CovLinPred(const arma::sp_mat& mCov_unique, const arma::uvec& uvPattern);
+
+  // Linear predictors of every pattern for vParams
+  //    Is const because only the cache changes but not what is returned for given vParams
+  const arma::vec& lin_pred(const arma::vec& vParams) const;
+
+  // Pattern of every customer
+  const arma::uvec uvPattern;
+
+  const arma::uword n_rows;
+  const arma::uword n_cols;
+  const arma::uword n_patterns;
+
+private:
+  const bool is_sparse;
+  const arma::mat mCov_dense;
+  const arma::sp_mat mCov_sparse;
+
+  mutable arma::vec vParams_cached;
+  mutable arma::vec vLinPred;
+  mutable unsigned int num_updates;
+};
+
+// StaticCovCache
+//    Lifetime and transaction covariates, kept between LL evaluations
+struct StaticCovCache{
+  StaticCovCache(const CovLinPred& life, const CovLinPred& trans) : life(life), trans(trans) {}
+
+  const CovLinPred life;
+  const CovLinPred trans;
+};
+
+// vec_exp_cov
+//    base * exp(sign * mCov * vParams) with the cached linear predictors
+//    exp() is evaluated once per pattern and then expanded to all customers
+arma::vec vec_exp_cov(const double base, const CovLinPred& mCov, const arma::vec& vParams, const double sign);
+
+// Covariate data of every customer from R (dense matrix or dgCMatrix), ie for predictions
+CovLinPred cov_lin_pred(SEXP mCov);
+
+// Cache from the external pointer created with clv_staticcov_cache_new()
+const StaticCovCache& staticcov_cache(SEXP ptrCovCache);
+
+}
+
+#endif
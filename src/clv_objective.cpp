@@ -0,0 +1,210 @@
+#include <RcppArmadillo.h>
+#include <math.h>
+#include <string>
+#include "core/clv_vectorized.h"
+
+// Individual LL kernels, see *_LL.cpp
+arma::vec pnbd_nocov_LL_ind(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
+arma::vec bgnbd_nocov_LL_ind(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
+arma::vec ggomnbd_nocov_LL_ind(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal);
+arma::vec pnbd_staticcov_cached_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache);
+arma::vec bgnbd_staticcov_cached_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache);
+arma::vec ggomnbd_staticcov_cached_LL_ind(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP ptrCovCache);
+
+namespace clv{
+
+// All kernels with the same signature. The nocov kernels do not use the covariate cache
+typedef arma::vec (*LLIndKernel)(const arma::vec&, const arma::vec&, const arma::vec&, const arma::vec&, SEXP);
+
+static arma::vec pnbd_nocov_kernel(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP){
+  return(pnbd_nocov_LL_ind(vLogparams, vX, vT_x, vT_cal));
+}
+static arma::vec bgnbd_nocov_kernel(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP){
+  return(bgnbd_nocov_LL_ind(vLogparams, vX, vT_x, vT_cal));
+}
+static arma::vec ggomnbd_nocov_kernel(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, SEXP){
+  return(ggomnbd_nocov_LL_ind(vLogparams, vX, vT_x, vT_cal));
+}
+
+static LLIndKernel LL_ind_kernel(const std::string& kernel){
+  if(kernel == "pnbd_nocov")        return(&pnbd_nocov_kernel);
+  if(kernel == "bgnbd_nocov")       return(&bgnbd_nocov_kernel);
+  if(kernel == "ggomnbd_nocov")     return(&ggomnbd_nocov_kernel);
+  if(kernel == "pnbd_staticcov")    return(&pnbd_staticcov_cached_LL_ind);
+  if(kernel == "bgnbd_staticcov")   return(&bgnbd_staticcov_cached_LL_ind);
+  if(kernel == "ggomnbd_staticcov") return(&ggomnbd_staticcov_cached_LL_ind);
+  throw std::runtime_error(std::string("There is no native objective for the LL kernel ") + kernel + "!");
+}
+
+
+// Objective
+//    The objective optimized when estimating: The LL kernel together with the constraints, regularization
+//    and correlation which are otherwise applied by the interlayers in R (interlayer_manager).
+//    Everything which does not depend on the params is prepared only once.
+struct Objective{
+  LLIndKernel fct_LL_ind;
+  arma::vec vX, vT_x, vT_cal, vWeights;
+  Rcpp::RObject cov_cache;
+
+  // Position of every kernel param in the optimizer params.
+  //    Constrained params are at the same position for life and trans
+  arma::uvec uvParamIndex;
+
+  // Regularization: Position of the life and trans covariate params in the kernel params
+  bool use_reg;
+  double reg_lambda_life, reg_lambda_trans, num_observations;
+  arma::uvec uvRegIndexLife, uvRegIndexTrans;
+
+  // Correlation: Position of param m in the optimizer params
+  bool use_cor;
+  arma::uword cor_index;
+
+  arma::vec LL_ind(const arma::vec& vKernelParams) const{
+    return(fct_LL_ind(vKernelParams, vX, vT_x, vT_cal, cov_cache));
+  }
+
+  // Same as interlayer_correlation. Pareto/NBD only
+  double LL_correlation(const arma::vec& vKernelParams, const double param_m, const bool check_param_m_bounds) const{
+    const double r       = exp(vKernelParams(0));
+    const double alpha_0 = exp(vKernelParams(1));
+    const double s       = exp(vKernelParams(2));
+    const double beta_0  = exp(vKernelParams(3));
+
+    // Laplace transformations
+    const double LA = std::pow(alpha_0 / (1 + alpha_0), r);
+    const double LB = std::pow(beta_0  / (1 + beta_0 ), s);
+
+    if(check_param_m_bounds){
+      const double upperbound =  1 / std::max(LA * (1 - LB), (1 - LA) * LB);
+      const double lowerbound = -1 / std::max(LA * LB,       (1 - LA) * (1 - LB));
+      if(param_m > upperbound || param_m < lowerbound)
+        return(NA_REAL);
+    }
+
+    // alpha and beta + 1 while keeping the others unchanged
+    arma::vec vParams10(vKernelParams), vParams01(vKernelParams), vParams11(vKernelParams);
+    vParams10(1) = log(alpha_0 + 1);
+    vParams01(3) = log(beta_0 + 1);
+    vParams11(1) = log(alpha_0 + 1);
+    vParams11(3) = log(beta_0 + 1);
+
+    const arma::vec vLL00 = LL_ind(vKernelParams);
+    const arma::vec vLL01 = LL_ind(vParams01);
+    const arma::vec vLL10 = LL_ind(vParams10);
+    const arma::vec vLL11 = LL_ind(vParams11);
+
+    if(!vLL00.is_finite() || !vLL01.is_finite() || !vLL10.is_finite() || !vLL11.is_finite())
+      return(NA_REAL);
+
+    const arma::vec vLL = arma::log(arma::exp(vLL00) +
+                                    param_m * LA * LB * (arma::exp(vLL00) + arma::exp(vLL11) - arma::exp(vLL10) - arma::exp(vLL01)));
+    return(clv::neg_sum_weighted(vLL, vWeights));
+  }
+
+  double eval(const arma::vec& vParams, const bool check_param_m_bounds) const{
+    if(uvParamIndex.n_elem > 0 && uvParamIndex.max() >= vParams.n_elem)
+      throw std::runtime_error(std::string("The params do not match the native objective!"));
+
+    const arma::vec vKernelParams = vParams.elem(uvParamIndex);
+
+    double LL;
+    if(use_cor)
+      LL = LL_correlation(vKernelParams, vParams(cor_index), check_param_m_bounds);
+    else
+      LL = clv::neg_sum_weighted(LL_ind(vKernelParams), vWeights);
+
+    if(!use_reg || !std::isfinite(LL))
+      return(LL);
+
+    // Same as interlayer_regularization
+    const arma::vec vParamsLife  = vKernelParams.elem(uvRegIndexLife);
+    const arma::vec vParamsTrans = vKernelParams.elem(uvRegIndexTrans);
+    return(LL / num_observations +
+           reg_lambda_trans * arma::dot(vParamsTrans, vParamsTrans) +
+           reg_lambda_life  * arma::dot(vParamsLife,  vParamsLife));
+  }
+};
+
+}
+
+
+//' @title Native objective function
+//'
+//' @param kernel Name of the LL kernel, ie \code{"pnbd_nocov"} or \code{"pnbd_staticcov"}.
+//' @param vX Frequency vector of length n counting the numbers of purchases.
+//' @param vT_x Recency vector of length n.
+//' @param vT_cal Vector of length n indicating the total number of periods of observation.
+//' @param vWeights Vector of length n with the weight of each customer's LogLikelihood in the sum. Customers are not weighted if of length 0.
+//' @param ptrCovCache Cache of the static covariate data, created with \code{clv_staticcov_cache_new}. \code{NULL} for models without covariates.
+//' @param vParamIndex Position (0-based) in the optimizer params of every param of the kernel.
+//' @param bUseReg Whether to regularize the covariate params.
+//' @param dRegLambdaLife,dRegLambdaTrans Regularization lambdas.
+//' @param dNumObservations Number of observations by which the LL is divided if regularized.
+//' @param vRegIndexLife,vRegIndexTrans Position (0-based) of the life and trans covariate params in the kernel params.
+//' @param iCorIndex Position (0-based) of the correlation param m in the optimizer params. Negative if no correlation.
+//'
+//' @description Prepares the objective function with everything that does not depend on the params.
+//' It is the same as evaluated by the interlayers in R: Constrained params are used for both processes,
+//' the correlation between both processes is modeled and the covariate params are regularized.
+//'
+//' @return External pointer to the objective. Evaluated with \code{clv_objective_eval}.
+//' @keywords internal
+// [[Rcpp::export]]
+SEXP clv_objective_new(const std::string& kernel,
+                       const arma::vec& vX,
+                       const arma::vec& vT_x,
+                       const arma::vec& vT_cal,
+                       const arma::vec& vWeights,
+                       SEXP ptrCovCache,
+                       const arma::vec& vParamIndex,
+                       const bool bUseReg,
+                       const double dRegLambdaLife,
+                       const double dRegLambdaTrans,
+                       const double dNumObservations,
+                       const arma::vec& vRegIndexLife,
+                       const arma::vec& vRegIndexTrans,
+                       const int iCorIndex){
+
+  if(iCorIndex >= 0 && kernel.compare(0, 5, "pnbd_") != 0)
+    throw std::runtime_error(std::string("The correlation is only available for the Pareto/NBD model!"));
+
+  clv::Objective* objective = new clv::Objective();
+  objective->fct_LL_ind       = clv::LL_ind_kernel(kernel);
+  objective->vX               = vX;
+  objective->vT_x             = vT_x;
+  objective->vT_cal           = vT_cal;
+  objective->vWeights         = vWeights;
+  objective->cov_cache        = ptrCovCache;
+  objective->uvParamIndex     = arma::conv_to<arma::uvec>::from(vParamIndex);
+  objective->use_reg          = bUseReg;
+  objective->reg_lambda_life  = dRegLambdaLife;
+  objective->reg_lambda_trans = dRegLambdaTrans;
+  objective->num_observations = dNumObservations;
+  objective->uvRegIndexLife   = arma::conv_to<arma::uvec>::from(vRegIndexLife);
+  objective->uvRegIndexTrans  = arma::conv_to<arma::uvec>::from(vRegIndexTrans);
+  objective->use_cor          = (iCorIndex >= 0);
+  objective->cor_index        = (iCorIndex >= 0) ? iCorIndex : 0;
+
+  Rcpp::XPtr<clv::Objective> ptr(objective, true);
+  return(ptr);
+}
+
+
+//' @title Evaluate the native objective function
+//'
+//' @param vParams Params as given by the optimizer.
+//' @param ptrObjective Objective created with \code{clv_objective_new}.
+//' @param bCheckParamMBounds Whether to return NA if the correlation param m is out of its bounds.
+//'
+//' @description Evaluates the objective function the same as \code{interlayer_manager}.
+//'
+//' @return The value of the objective function.
+//' @keywords internal
+// [[Rcpp::export]]
+double clv_objective_eval(const arma::vec& vParams, SEXP ptrObjective, const bool bCheckParamMBounds){
+  const Rcpp::XPtr<clv::Objective> ptr(ptrObjective);
+  // Pointers are NULL after the R session was restored
+  if(ptr.get() == NULL)
+    throw std::runtime_error(std::string("The native objective is not valid anymore!"));
+  return(ptr->eval(vParams, bCheckParamMBounds));
+}
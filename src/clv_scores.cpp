@@ -0,0 +1,354 @@
+#include <RcppArmadillo.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "core/clv_vectorized.h"
+#include "core/pnbd.h"
+#include "core/bgnbd.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace clv{
+
+// Customers are processed in blocks of fixed size when accumulating the meat matrix
+const arma::uword SCORES_BLOCK_SIZE = 10000;
+
+// LLScores
+//    Derivatives of every customer's LL by the log of the model params and by the linear predictors
+//    (covariate data times params) of the lifetime and transaction covariates.
+//    The scores of the covariate params are the latter times the covariate data:
+//      dLL_i / dgamma_j = vLife(i) * mCov_life(i, j)
+//
+//    Every customer's LL only depends on the customer's own alpha_i, beta_i, a_i, b_i. Therefore the derivatives
+//    by these are derived for a whole block of customers at once, with a single central difference of the vectorized LL.
+//    This needs as many LL evaluations as the model has params, regardless of the number of covariates.
+struct LLScores{
+  arma::mat mModel;
+  arma::vec vLife;
+  arma::vec vTrans;
+};
+
+// Step on log-scale for the central differences, optimal for the first derivative
+static double score_step(){
+  return(std::cbrt(std::numeric_limits<double>::epsilon()));
+}
+
+// Customer-specific params from which the LLScores of any block of customers (first to last, incl) are derived
+class PnbdScores{
+public:
+  PnbdScores(const double r, const double s, const arma::vec& vAlpha_i, const arma::vec& vBeta_i,
+             const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal)
+    : r(r), s(s), vAlpha_i(vAlpha_i), vBeta_i(vBeta_i), vX(vX), vT_x(vT_x), vT_cal(vT_cal) {}
+
+  arma::uword num_customers() const {return(vX.n_elem);}
+
+  LLScores block(const arma::uword first, const arma::uword last) const {
+    const double h = score_step();
+    const arma::vec vAlpha = vAlpha_i.subvec(first, last), vBeta = vBeta_i.subvec(first, last);
+    const arma::vec vX_b = vX.subvec(first, last), vT_x_b = vT_x.subvec(first, last), vT_cal_b = vT_cal.subvec(first, last);
+
+    LLScores scores;
+    scores.mModel.set_size(vX_b.n_elem, 4);
+    scores.mModel.col(0) = (pnbd_LL_ind(r * exp(h), s, vAlpha, vBeta, vX_b, vT_x_b, vT_cal_b) -
+                            pnbd_LL_ind(r * exp(-h), s, vAlpha, vBeta, vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+    scores.mModel.col(1) = (pnbd_LL_ind(r, s, vAlpha * exp(h), vBeta, vX_b, vT_x_b, vT_cal_b) -
+                            pnbd_LL_ind(r, s, vAlpha * exp(-h), vBeta, vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+    scores.mModel.col(2) = (pnbd_LL_ind(r, s * exp(h), vAlpha, vBeta, vX_b, vT_x_b, vT_cal_b) -
+                            pnbd_LL_ind(r, s * exp(-h), vAlpha, vBeta, vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+    scores.mModel.col(3) = (pnbd_LL_ind(r, s, vAlpha, vBeta * exp(h), vX_b, vT_x_b, vT_cal_b) -
+                            pnbd_LL_ind(r, s, vAlpha, vBeta * exp(-h), vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+
+    //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
+    //    beta_i:  beta0  * exp(-cov.life  * cov.params.life)
+    scores.vLife  = -scores.mModel.col(3);
+    scores.vTrans = -scores.mModel.col(1);
+    return(scores);
+  }
+
+private:
+  const double r, s;
+  const arma::vec vAlpha_i, vBeta_i;
+  const arma::vec &vX, &vT_x, &vT_cal;
+};
+
+class BgnbdScores{
+public:
+  BgnbdScores(const double r, const arma::vec& vAlpha_i, const arma::vec& vA_i, const arma::vec& vB_i,
+              const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal)
+    : r(r), vAlpha_i(vAlpha_i), vA_i(vA_i), vB_i(vB_i), vX(vX), vT_x(vT_x), vT_cal(vT_cal) {}
+
+  arma::uword num_customers() const {return(vX.n_elem);}
+
+  LLScores block(const arma::uword first, const arma::uword last) const {
+    const double h = score_step();
+    const arma::vec vAlpha = vAlpha_i.subvec(first, last), vA = vA_i.subvec(first, last), vB = vB_i.subvec(first, last);
+    const arma::vec vX_b = vX.subvec(first, last), vT_x_b = vT_x.subvec(first, last), vT_cal_b = vT_cal.subvec(first, last);
+
+    LLScores scores;
+    scores.mModel.set_size(vX_b.n_elem, 4);
+    scores.mModel.col(0) = (bgnbd_LL_ind(r * exp(h), vAlpha, vA, vB, vX_b, vT_x_b, vT_cal_b) -
+                            bgnbd_LL_ind(r * exp(-h), vAlpha, vA, vB, vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+    scores.mModel.col(1) = (bgnbd_LL_ind(r, vAlpha * exp(h), vA, vB, vX_b, vT_x_b, vT_cal_b) -
+                            bgnbd_LL_ind(r, vAlpha * exp(-h), vA, vB, vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+    scores.mModel.col(2) = (bgnbd_LL_ind(r, vAlpha, vA * exp(h), vB, vX_b, vT_x_b, vT_cal_b) -
+                            bgnbd_LL_ind(r, vAlpha, vA * exp(-h), vB, vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+    scores.mModel.col(3) = (bgnbd_LL_ind(r, vAlpha, vA, vB * exp(h), vX_b, vT_x_b, vT_cal_b) -
+                            bgnbd_LL_ind(r, vAlpha, vA, vB * exp(-h), vX_b, vT_x_b, vT_cal_b)) / (2 * h);
+
+    //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
+    //    a_i:     a0 * exp(cov.life * cov.param.life)
+    //    b_i:     b0 * exp(cov.life * cov.param.life)
+    scores.vLife  = scores.mModel.col(2) + scores.mModel.col(3);
+    scores.vTrans = -scores.mModel.col(1);
+    return(scores);
+  }
+
+private:
+  const double r;
+  const arma::vec vAlpha_i, vA_i, vB_i;
+  const arma::vec &vX, &vT_x, &vT_cal;
+};
+
+// Scores of the block of customers first to last (incl), in the order of the params: model, life, trans
+template<typename TMat>
+arma::mat scores_matrix(const LLScores& block_scores, const TMat& mCov_life, const TMat& mCov_trans,
+                        const arma::uword first, const arma::uword last){
+  arma::mat mLife(mCov_life.rows(first, last));
+  arma::mat mTrans(mCov_trans.rows(first, last));
+  mLife.each_col()  %= block_scores.vLife;
+  mTrans.each_col() %= block_scores.vTrans;
+  return(arma::join_rows(arma::join_rows(block_scores.mModel, mLife), mTrans));
+}
+
+// Scores of all customers
+template<typename TScores, typename TMat>
+arma::mat scores_all(const TScores& scores, const TMat& mCov_life, const TMat& mCov_trans){
+  const arma::uword n = scores.num_customers();
+  if(n == 0)
+    return(arma::mat(0, 4 + mCov_life.n_cols + mCov_trans.n_cols));
+  return(scores_matrix(scores.block(0, n - 1), mCov_life, mCov_trans, 0, n - 1));
+}
+
+// Meat of the sandwich estimator
+//    sum_i w_i * s_i * s_i'  or, if clustered,  sum_c (sum_{i in c} w_i * s_i) * (sum_{i in c} w_i * s_i)'
+//    The scores are derived and accumulated per thread in blocks of customers without ever building the full score matrix
+template<typename TScores, typename TMat>
+arma::mat scores_meat(const TScores& scores, const TMat& mCov_life, const TMat& mCov_trans,
+                      const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads){
+  const arma::uword n = scores.num_customers();
+  const arma::uword k = 4 + mCov_life.n_cols + mCov_trans.n_cols;
+
+  const bool is_weighted  = vWeights.n_elem > 0;
+  const bool is_clustered = vCluster.n_elem > 0;
+  if(is_weighted && vWeights.n_elem != n)
+    throw std::out_of_range("There need to be as many weights as customers!");
+  if(is_clustered && vCluster.n_elem != n)
+    throw std::out_of_range("There need to be as many clusters as customers!");
+  if(is_clustered && n > 0 && vCluster.min() < 0)
+    throw std::out_of_range("The clusters need to be given as 0-based index!");
+
+  const arma::uword num_clusters = (is_clustered && n > 0) ? static_cast<arma::uword>(vCluster.max()) + 1 : 0;
+  const arma::uword num_blocks   = (n + SCORES_BLOCK_SIZE - 1) / SCORES_BLOCK_SIZE;
+
+  int num_threads_used = 1;
+#ifdef _OPENMP
+  num_threads_used = std::max(1, num_threads);
+#endif
+
+  // Per thread: Either the meat or the summed scores of every cluster
+  std::vector<arma::mat> vAccumulated(num_threads_used,
+                                      arma::mat(is_clustered ? num_clusters : k, k, arma::fill::zeros));
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(num_threads_used)
+#endif
+  for(arma::uword b = 0; b < num_blocks; b++){
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    const arma::uword first = b * SCORES_BLOCK_SIZE;
+    const arma::uword last  = std::min(first + SCORES_BLOCK_SIZE, n) - 1;
+
+    const arma::mat mScores = scores_matrix(scores.block(first, last), mCov_life, mCov_trans, first, last);
+    arma::mat mScoresWeighted(mScores);
+    if(is_weighted)
+      mScoresWeighted.each_col() %= vWeights.subvec(first, last);
+
+    if(is_clustered){
+      for(arma::uword i = 0; i < mScores.n_rows; i++)
+        vAccumulated[thread].row(static_cast<arma::uword>(vCluster(first + i))) += mScoresWeighted.row(i);
+    }else{
+      vAccumulated[thread] += mScoresWeighted.t() * mScores;
+    }
+  }
+
+  arma::mat mAccumulated = vAccumulated[0];
+  for(int t = 1; t < num_threads_used; t++)
+    mAccumulated += vAccumulated[t];
+
+  if(is_clustered)
+    return(mAccumulated.t() * mAccumulated);
+  return(mAccumulated);
+}
+
+static void check_num_params(const arma::vec& vParams, const arma::uword no_cov_life, const arma::uword no_cov_trans){
+  if(vParams.n_elem != 4 + no_cov_life + no_cov_trans)
+    throw std::out_of_range("There need to be as many covariate parameters as covariates!");
+}
+
+// num elements of vParams starting at first. Empty if there are no covariates
+static arma::vec params_cov(const arma::vec& vParams, const arma::uword first, const arma::uword num){
+  if(num == 0)
+    return(arma::vec());
+  return(vParams.subvec(first, first + num - 1));
+}
+
+template<typename TMat>
+PnbdScores pnbd_staticcov_scores(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                               const TMat& mCov_life, const TMat& mCov_trans){
+  check_num_params(vParams, mCov_life.n_cols, mCov_trans.n_cols);
+  const arma::vec vLife_params  = params_cov(vParams, 4, mCov_life.n_cols);
+  const arma::vec vTrans_params = params_cov(vParams, 4 + mCov_life.n_cols, mCov_trans.n_cols);
+
+  const arma::vec vAlpha_i = clv::vec_exp_cov(exp(vParams(1)), mCov_trans, vTrans_params, -1);
+  const arma::vec vBeta_i  = clv::vec_exp_cov(exp(vParams(3)), mCov_life,  vLife_params,  -1);
+  return(PnbdScores(exp(vParams(0)), exp(vParams(2)), vAlpha_i, vBeta_i, vX, vT_x, vT_cal));
+}
+
+template<typename TMat>
+BgnbdScores bgnbd_staticcov_scores(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                                const TMat& mCov_life, const TMat& mCov_trans){
+  check_num_params(vParams, mCov_life.n_cols, mCov_trans.n_cols);
+  const arma::vec vLife_params  = params_cov(vParams, 4, mCov_life.n_cols);
+  const arma::vec vTrans_params = params_cov(vParams, 4 + mCov_life.n_cols, mCov_trans.n_cols);
+
+  const arma::vec vAlpha_i = clv::vec_exp_cov(exp(vParams(1)), mCov_trans, vTrans_params, -1);
+  const arma::vec vA_i     = clv::vec_exp_cov(exp(vParams(2)), mCov_life,  vLife_params,   1);
+  const arma::vec vB_i     = vA_i * (exp(vParams(3)) / exp(vParams(2)));
+  return(BgnbdScores(exp(vParams(0)), vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal));
+}
+
+}
+
+// No covariates: no columns
+static arma::mat no_cov(const arma::vec& vX){
+  return(arma::mat(vX.n_elem, 0));
+}
+
+
+//' @name LL_scores
+//' @title Scores of the individual LogLikelihood
+//'
+//' @param vLogparams Vector with the model parameters on log scale, in the order of the LL functions.
+//' @param vParams Vector with the model parameters on log scale, followed by the lifetime and transaction covariate parameters.
+//' @template template_params_rcppxtxtcal
+//' @param mCov_life Matrix or sparse matrix (\code{dgCMatrix}) containing the covariates data affecting the lifetime process.
+//' @param mCov_trans Matrix or sparse matrix (\code{dgCMatrix}) containing the covariates data affecting the transaction process. Of the same type as \code{mCov_life}.
+//' @param vWeights Vector with the weight of every customer. Not weighted if of length 0.
+//' @param vCluster Vector with the 0-based cluster index of every customer. Not clustered if of length 0.
+//' @param num_threads Number of threads to use.
+//'
+//' @description
+//' Derivatives of every customer's LogLikelihood by the parameters (scores), in the same order and on
+//' the same scale as the parameters are given.
+//'
+//' \code{_LL_scores} returns the n x k matrix of scores S.
+//'
+//' \code{_LL_meat} returns the k x k matrix S' W S where W are the weights. If clustered, the weighted scores
+//' are first summed per cluster. The scores are derived and accumulated in parallel in blocks of customers without building S.
+//'
+//' @details
+//' Every customer's LogLikelihood only depends on the customer's own parameters (ie alpha_i and beta_i).
+//' The derivatives by these are therefore derived for all customers at once with central differences of the
+//' vectorized LogLikelihood. The derivatives by the covariate parameters follow from the chain rule.
+//'
+//' @return
+//' The n x k matrix of scores or the k x k meat matrix.
+//'
+//' @keywords internal
+// [[Rcpp::export]]
+arma::mat pnbd_nocov_LL_scores(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal){
+  const arma::mat mCov = no_cov(vX);
+  const clv::PnbdScores scores = clv::pnbd_staticcov_scores(vLogparams, vX, vT_x, vT_cal, mCov, mCov);
+  return(clv::scores_all(scores, mCov, mCov));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat pnbd_nocov_LL_meat(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                             const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads){
+  const arma::mat mCov = no_cov(vX);
+  const clv::PnbdScores scores = clv::pnbd_staticcov_scores(vLogparams, vX, vT_x, vT_cal, mCov, mCov);
+  return(clv::scores_meat(scores, mCov, mCov, vWeights, vCluster, num_threads));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat pnbd_staticcov_LL_scores(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                                   SEXP mCov_life, SEXP mCov_trans){
+  if(Rf_isS4(mCov_life)){
+    const arma::sp_mat mLife = Rcpp::as<arma::sp_mat>(mCov_life), mTrans = Rcpp::as<arma::sp_mat>(mCov_trans);
+    return(clv::scores_all(clv::pnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans));
+  }
+  const arma::mat mLife = Rcpp::as<arma::mat>(mCov_life), mTrans = Rcpp::as<arma::mat>(mCov_trans);
+  return(clv::scores_all(clv::pnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat pnbd_staticcov_LL_meat(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                                 SEXP mCov_life, SEXP mCov_trans,
+                                 const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads){
+  if(Rf_isS4(mCov_life)){
+    const arma::sp_mat mLife = Rcpp::as<arma::sp_mat>(mCov_life), mTrans = Rcpp::as<arma::sp_mat>(mCov_trans);
+    return(clv::scores_meat(clv::pnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans, vWeights, vCluster, num_threads));
+  }
+  const arma::mat mLife = Rcpp::as<arma::mat>(mCov_life), mTrans = Rcpp::as<arma::mat>(mCov_trans);
+  return(clv::scores_meat(clv::pnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans, vWeights, vCluster, num_threads));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat bgnbd_nocov_LL_scores(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal){
+  const arma::mat mCov = no_cov(vX);
+  const clv::BgnbdScores scores = clv::bgnbd_staticcov_scores(vLogparams, vX, vT_x, vT_cal, mCov, mCov);
+  return(clv::scores_all(scores, mCov, mCov));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat bgnbd_nocov_LL_meat(const arma::vec& vLogparams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                              const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads){
+  const arma::mat mCov = no_cov(vX);
+  const clv::BgnbdScores scores = clv::bgnbd_staticcov_scores(vLogparams, vX, vT_x, vT_cal, mCov, mCov);
+  return(clv::scores_meat(scores, mCov, mCov, vWeights, vCluster, num_threads));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat bgnbd_staticcov_LL_scores(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                                    SEXP mCov_life, SEXP mCov_trans){
+  if(Rf_isS4(mCov_life)){
+    const arma::sp_mat mLife = Rcpp::as<arma::sp_mat>(mCov_life), mTrans = Rcpp::as<arma::sp_mat>(mCov_trans);
+    return(clv::scores_all(clv::bgnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans));
+  }
+  const arma::mat mLife = Rcpp::as<arma::mat>(mCov_life), mTrans = Rcpp::as<arma::mat>(mCov_trans);
+  return(clv::scores_all(clv::bgnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans));
+}
+
+//' @rdname LL_scores
+// [[Rcpp::export]]
+arma::mat bgnbd_staticcov_LL_meat(const arma::vec& vParams, const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal,
+                                  SEXP mCov_life, SEXP mCov_trans,
+                                  const arma::vec& vWeights, const arma::vec& vCluster, const int num_threads){
+  if(Rf_isS4(mCov_life)){
+    const arma::sp_mat mLife = Rcpp::as<arma::sp_mat>(mCov_life), mTrans = Rcpp::as<arma::sp_mat>(mCov_trans);
+    return(clv::scores_meat(clv::bgnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans, vWeights, vCluster, num_threads));
+  }
+  const arma::mat mLife = Rcpp::as<arma::mat>(mCov_life), mTrans = Rcpp::as<arma::mat>(mCov_trans);
+  return(clv::scores_meat(clv::bgnbd_staticcov_scores(vParams, vX, vT_x, vT_cal, mLife, mTrans), mLife, mTrans, vWeights, vCluster, num_threads));
+}
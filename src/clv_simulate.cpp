@@ -0,0 +1,335 @@
+#include <RcppArmadillo.h>
+#include <math.h>
+#include <vector>
+#include <random>
+#include <string>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// Customers are simulated in blocks of fixed size. Every block draws from its own RNG stream
+//  which is seeded from (seed, block index). The simulated data therefore only depends on the
+//  seed and not on the number of threads or the order in which the blocks are processed.
+const arma::uword SIMULATE_BLOCK_SIZE = 10000;
+
+enum simulate_model {SIMULATE_PNBD, SIMULATE_BGNBD, SIMULATE_GGOMNBD};
+
+struct simulated_block {
+  std::vector<int>    vId;
+  std::vector<double> vTime;
+  std::vector<double> vPrice;
+};
+
+
+// Samplers --------------------------------------------------------------------------------------
+//    The distributions of the standard library are implementation-defined and do not produce the same
+//    numbers on all platforms. Only the raw output of mt19937_64 is fully specified. All samplers are
+//    therefore implemented explicitly on top of it.
+
+// Uniform in the open interval (0, 1), from the upper 53 bits
+inline double draw_unif(std::mt19937_64& rng){
+  return ((rng() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Exponential with rate, by inverse CDF
+inline double draw_exp(std::mt19937_64& rng, const double rate){
+  return -std::log(draw_unif(rng)) / rate;
+}
+
+// Standard normal, with the Marsaglia polar method
+//    The second value of the pair is discarded to keep the sampler without state
+inline double draw_norm(std::mt19937_64& rng){
+  double u, v, s;
+  do{
+    u = 2.0 * draw_unif(rng) - 1.0;
+    v = 2.0 * draw_unif(rng) - 1.0;
+    s = u*u + v*v;
+  }while(s >= 1.0);
+  return u * std::sqrt(-2.0 * std::log(s) / s);
+}
+
+// Gamma with shape and rate, with the method of Marsaglia and Tsang (2000)
+//    For shape < 1: Gamma(shape) = Gamma(shape+1) * U^(1/shape)
+double draw_gamma(std::mt19937_64& rng, const double shape, const double rate){
+  if(shape < 1.0)
+    return draw_gamma(rng, shape + 1.0, rate) * std::pow(draw_unif(rng), 1.0 / shape);
+
+  const double d = shape - 1.0/3.0;
+  const double c = 1.0 / std::sqrt(9.0 * d);
+  double x, v, u;
+  while(true){
+    do{
+      x = draw_norm(rng);
+      v = 1.0 + c * x;
+    }while(v <= 0.0);
+    v = v * v * v;
+    u = draw_unif(rng);
+    if(u < 1.0 - 0.0331 * x*x*x*x)
+      break;
+    if(std::log(u) < 0.5 * x*x + d * (1.0 - v + std::log(v)))
+      break;
+  }
+  return d * v / rate;
+}
+
+
+// Draw the transaction times of a single customer
+//    Births are uniform in [0, dAcquisitionPeriods], all transactions after dObservationPeriods are discarded.
+//    The first transaction happens at birth.
+void simulate_customer(const simulate_model model,
+                       const double r, const double alpha_i,
+                       const double p2, const double p3, const double p4, // model specific, see below
+                       const double dAcquisitionPeriods,
+                       const double dObservationPeriods,
+                       std::mt19937_64& rng,
+                       std::vector<double>& vTimes){
+
+  // Purchase process is the same for all models: lambda ~ Gamma(shape=r, rate=alpha_i)
+  const double lambda = draw_gamma(rng, r, alpha_i);
+
+  const double birth = draw_unif(rng) * dAcquisitionPeriods;
+  if(birth > dObservationPeriods)
+    return;
+
+  // Time of death, relative to birth. Not needed for BG/NBD where dropout happens after transactions
+  double death = std::numeric_limits<double>::infinity();
+  double p_dropout = 0.0;
+
+  if(model == SIMULATE_PNBD){
+    // p2 = s, p3 = beta_i
+    //  mu ~ Gamma(shape=s, rate=beta_i), tau ~ Exp(mu)
+    const double mu = draw_gamma(rng, p2, p3);
+    if(mu > 0)
+      death = draw_exp(rng, mu);
+  }else if(model == SIMULATE_BGNBD){
+    // p2 = a_i, p3 = b_i
+    //  p ~ Beta(a_i, b_i), drawn as ratio of gammas
+    const double x = draw_gamma(rng, p2, 1.0);
+    const double y = draw_gamma(rng, p3, 1.0);
+    p_dropout = x / (x + y);
+  }else{
+    // p2 = b, p3 = s, p4 = beta_i
+    //  eta ~ Gamma(shape=s, rate=beta_i), tau ~ Gompertz(b, eta)
+    //  Inverse of the Gompertz survival function exp(-eta*(exp(b*tau)-1))
+    const double eta = draw_gamma(rng, p3, p4);
+    death = std::log(1.0 - std::log(draw_unif(rng)) / eta) / p2;
+  }
+
+  const double end = std::min(birth + death, dObservationPeriods);
+
+  vTimes.push_back(birth);
+
+  // Gamma draws with small shape can underflow to 0: No repeat transactions at all
+  if(!(lambda > 0))
+    return;
+
+  double t = birth;
+  while(true){
+    t += draw_exp(rng, lambda);
+    if(t > end)
+      break;
+    vTimes.push_back(t);
+
+    // BG/NBD: Become inactive after a repeat transaction with probability p
+    if(model == SIMULATE_BGNBD && draw_unif(rng) < p_dropout)
+      break;
+  }
+}
+
+
+//' @title Simulate transaction histories
+//'
+//' @description
+//' Simulates the transaction times of \code{n} customers from the Pareto/NBD, BG/NBD or GGompertz/NBD
+//' model. Customers are born uniformly within the first \code{dAcquisitionPeriods} and their transactions
+//' are observed until \code{dObservationPeriods}. Every customer's first transaction is at birth.
+//'
+//' If \code{vSpendingParams} (p, q, gamma) is given, the value of every transaction is drawn from the
+//' Gamma/Gamma spending model.
+//'
+//' @param model Single string, one of "pnbd", "bgnbd", "ggomnbd"
+//' @param vModelParams Model parameters on their original scale, in the same order as the model's
+//' parameters: (r, alpha, s, beta) for pnbd, (r, alpha, a, b) for bgnbd, and (r, alpha, b, s, beta) for ggomnbd
+//' @param vSpendingParams Either empty or the parameters (p, q, gamma) of the Gamma/Gamma spending model
+//' @param n Number of customers to simulate
+//' @param dAcquisitionPeriods Length of the period in which customers are born
+//' @param dObservationPeriods Length of the period in which transactions are observed
+//' @template template_params_rcppcovmatrix
+//' @template template_params_rcppvcovparams
+//' @param seed Seed for the random number streams
+//' @param num_threads Number of threads to use. Has no influence on the simulated data.
+//'
+//' @details
+//' The covariate matrices either have zero columns (no covariates) or \code{n} rows. Covariates enter the
+//' same way as in the respective LL: alpha_i = alpha * exp(-mCov_trans * vCovParams_trans) for all models,
+//' beta_i = beta * exp(-mCov_life * vCovParams_life) for pnbd and ggomnbd, and a_i = a * exp(mCov_life * vCovParams_life),
+//' b_i = b * exp(mCov_life * vCovParams_life) for bgnbd.
+//'
+//' The random numbers are not drawn from R's RNG but from independent mt19937_64 streams per block of customers.
+//' All distributions are sampled explicitly (inverse CDF, Marsaglia polar and Marsaglia-Tsang) instead of with the
+//' implementation-defined distributions of the standard library.
+//' Results are reproducible for a given \code{seed} regardless of \code{num_threads} and platform.
+//'
+//' @return
+//' List with the elements \code{Id} (integer, 1 to n), \code{Time} (time of transaction since the
+//' start of the acquisition period, in periods) and \code{Price} (\code{NULL} if no spending parameters given).
+//' Transactions are sorted by Id and Time.
+//'
+//' @keywords internal
+// [[Rcpp::export]]
+Rcpp::List clv_simulate(const std::string& model,
+                        const arma::vec& vModelParams,
+                        const arma::vec& vSpendingParams,
+                        const int n,
+                        const double dAcquisitionPeriods,
+                        const double dObservationPeriods,
+                        const arma::mat& mCov_life,
+                        const arma::mat& mCov_trans,
+                        const arma::vec& vCovParams_life,
+                        const arma::vec& vCovParams_trans,
+                        const int seed,
+                        const int num_threads){
+
+  // Check inputs ------------------------------------------------------------------------------
+  simulate_model sim_model;
+  arma::uword num_model_params;
+  if(model == "pnbd"){
+    sim_model = SIMULATE_PNBD;
+    num_model_params = 4;
+  }else if(model == "bgnbd"){
+    sim_model = SIMULATE_BGNBD;
+    num_model_params = 4;
+  }else if(model == "ggomnbd"){
+    sim_model = SIMULATE_GGOMNBD;
+    num_model_params = 5;
+  }else{
+    throw std::invalid_argument("Unknown model, only pnbd, bgnbd and ggomnbd can be simulated!");
+  }
+
+  if(n < 0)
+    throw std::out_of_range("The number of customers may not be negative!");
+
+  if(vModelParams.n_elem != num_model_params)
+    throw std::out_of_range("Wrong number of model parameters!");
+
+  if(arma::any(vModelParams <= 0))
+    throw std::out_of_range("All model parameters need to be greater than 0!");
+
+  if(!std::isfinite(dAcquisitionPeriods) || !std::isfinite(dObservationPeriods) ||
+     dAcquisitionPeriods < 0 || dObservationPeriods < 0)
+    throw std::out_of_range("The acquisition and observation periods need to be finite and not negative!");
+
+  if(num_threads < 1)
+    throw std::out_of_range("The number of threads needs to be at least 1!");
+
+  if(vSpendingParams.n_elem != 0 && vSpendingParams.n_elem != 3)
+    throw std::out_of_range("The spending parameters need to be empty or (p, q, gamma)!");
+
+  if(vCovParams_trans.n_elem != mCov_trans.n_cols)
+    throw std::out_of_range("Vector of transaction parameters need to have same length as number of columns in transaction covariates!");
+
+  if(vCovParams_life.n_elem != mCov_life.n_cols)
+    throw std::out_of_range("Vector of lifetime parameters need to have same length as number of columns in lifetime covariates!");
+
+  if((mCov_trans.n_cols > 0 && mCov_trans.n_rows != static_cast<arma::uword>(n)) ||
+     (mCov_life.n_cols  > 0 && mCov_life.n_rows  != static_cast<arma::uword>(n)))
+    throw std::out_of_range("There need to be as many covariate rows as customers!");
+
+
+  // Customer specific parameters -------------------------------------------------------------
+  //    Without covariates: Same for every customer
+  const double r = vModelParams(0);
+
+  arma::vec vAlpha_i(n), vP2_i(n), vP3_i(n), vP4_i(n);
+  vAlpha_i.fill(vModelParams(1));
+
+  if(mCov_trans.n_cols > 0)
+    vAlpha_i %= arma::exp((mCov_trans * (-1)) * vCovParams_trans);
+
+  arma::vec vLifeFactor(n);
+  vLifeFactor.fill(1.0);
+  if(mCov_life.n_cols > 0)
+    vLifeFactor = arma::exp(mCov_life * vCovParams_life);
+
+  if(sim_model == SIMULATE_PNBD){
+    vP2_i.fill(vModelParams(2));                    // s
+    vP3_i = vModelParams(3) / vLifeFactor;          // beta_i
+    vP4_i.zeros();
+  }else if(sim_model == SIMULATE_BGNBD){
+    vP2_i = vModelParams(2) * vLifeFactor;          // a_i
+    vP3_i = vModelParams(3) * vLifeFactor;          // b_i
+    vP4_i.zeros();
+  }else{
+    vP2_i.fill(vModelParams(2));                    // b
+    vP3_i.fill(vModelParams(3));                    // s
+    vP4_i = vModelParams(4) / vLifeFactor;          // beta_i
+  }
+
+  const bool has_spending = vSpendingParams.n_elem == 3;
+
+
+  // Simulate per block ------------------------------------------------------------------------
+  const arma::uword num_blocks = (static_cast<arma::uword>(n) + SIMULATE_BLOCK_SIZE - 1) / SIMULATE_BLOCK_SIZE;
+  std::vector<simulated_block> vBlocks(num_blocks);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+#endif
+  for(arma::uword b = 0; b < num_blocks; b++){
+    std::seed_seq seq{static_cast<unsigned int>(seed), static_cast<unsigned int>(b)};
+    std::mt19937_64 rng(seq);
+
+    simulated_block& block = vBlocks[b];
+    std::vector<double> vTimes;
+
+    const arma::uword first = b * SIMULATE_BLOCK_SIZE;
+    const arma::uword last  = std::min(first + SIMULATE_BLOCK_SIZE, static_cast<arma::uword>(n));
+    for(arma::uword i = first; i < last; i++){
+      vTimes.clear();
+      simulate_customer(sim_model, r, vAlpha_i(i), vP2_i(i), vP3_i(i), vP4_i(i),
+                        dAcquisitionPeriods, dObservationPeriods, rng, vTimes);
+
+      block.vId.insert(block.vId.end(), vTimes.size(), static_cast<int>(i + 1));
+      block.vTime.insert(block.vTime.end(), vTimes.begin(), vTimes.end());
+
+      // Gamma/Gamma: nu_i ~ Gamma(shape=q, rate=gamma), z ~ Gamma(shape=p, rate=nu_i)
+      if(has_spending && vTimes.size() > 0){
+        const double nu = draw_gamma(rng, vSpendingParams(1), vSpendingParams(2));
+        for(std::size_t j = 0; j < vTimes.size(); j++)
+          block.vPrice.push_back(draw_gamma(rng, vSpendingParams(0), nu));
+      }
+    }
+  }
+
+
+  // Collect blocks ----------------------------------------------------------------------------
+  //    Only here R memory is allocated, single-threaded
+  std::size_t num_trans = 0;
+  for(arma::uword b = 0; b < num_blocks; b++)
+    num_trans += vBlocks[b].vId.size();
+
+  Rcpp::IntegerVector vId(num_trans);
+  Rcpp::NumericVector vTime(num_trans);
+  Rcpp::NumericVector vPrice(has_spending ? num_trans : 0);
+
+  std::size_t pos = 0;
+  for(arma::uword b = 0; b < num_blocks; b++){
+    std::copy(vBlocks[b].vId.begin(),   vBlocks[b].vId.end(),   vId.begin()   + pos);
+    std::copy(vBlocks[b].vTime.begin(), vBlocks[b].vTime.end(), vTime.begin() + pos);
+    if(has_spending)
+      std::copy(vBlocks[b].vPrice.begin(), vBlocks[b].vPrice.end(), vPrice.begin() + pos);
+    pos += vBlocks[b].vId.size();
+
+    // Free memory early
+    std::vector<int>().swap(vBlocks[b].vId);
+    std::vector<double>().swap(vBlocks[b].vTime);
+    std::vector<double>().swap(vBlocks[b].vPrice);
+  }
+
+  return Rcpp::List::create(Rcpp::Named("Id")    = vId,
+                            Rcpp::Named("Time")  = vTime,
+                            Rcpp::Named("Price") = has_spending ? Rcpp::RObject(vPrice) : Rcpp::RObject(R_NilValue));
+}
@@ -0,0 +1,78 @@
+// Benchmarks of the core kernels, without R
+//    Time per evaluation for all customers, as in a single LL evaluation during estimation or
+//    when scoring a batch of customers.
+//
+//    clvcore_bench [num_customers] [num_repetitions]
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "clv_core.h"
+
+// Median over the repetitions of the time to run fct once, in milliseconds
+template<typename TFct>
+static double time_ms(const TFct& fct, const int num_repetitions){
+  arma::vec vTimes(num_repetitions);
+  for(int i = 0; i < num_repetitions; i++){
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const arma::vec vRes = fct();
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    vTimes(i) = std::chrono::duration<double, std::milli>(end - start).count();
+
+    // Use the result to not have the evaluation optimized away
+    if(!vRes.is_finite())
+      std::cerr << "Non-finite result" << std::endl;
+  }
+  return(arma::median(vTimes));
+}
+
+static void report(const std::string& name, const double ms, const arma::uword n){
+  std::cout << std::left << std::setw(24) << name
+            << std::right << std::setw(12) << std::fixed << std::setprecision(3) << ms << " ms"
+            << std::setw(12) << std::setprecision(1) << (1e6 * ms / n) << " ns/customer" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+  const arma::uword n       = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 100000;
+  const int num_repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  // Customers similar to the CDNOW data: Mostly few transactions in an estimation period of 39 weeks
+  arma::arma_rng::set_seed(1234);
+  const arma::vec vT_cal = 39 * arma::ones<arma::vec>(n) - arma::randu<arma::vec>(n) * 12;
+  const arma::vec vX     = arma::floor(arma::randg<arma::vec>(n, arma::distr_param(0.5, 3.0)));
+  arma::vec vT_x         = vT_cal % arma::randu<arma::vec>(n);
+  vT_x(arma::find(vX == 0)).zeros();
+  const arma::vec vM_x   = (vX > 0) % (10 + 40 * arma::randu<arma::vec>(n));
+
+  const arma::vec vOnes = arma::ones<arma::vec>(n);
+
+  std::cout << "Customers: " << n << ", repetitions: " << num_repetitions << std::endl;
+
+  // Pareto/NBD
+  const double r = 0.55, s = 0.61;
+  const arma::vec vAlpha_i = 10.58 * vOnes, vBeta_i = 11.67 * vOnes;
+  const arma::vec vPAlive = clv::pnbd_PAlive(r, s, vX, vT_x, vT_cal, vAlpha_i, vBeta_i);
+  report("pnbd_LL_ind",   time_ms([&](){ return(clv::pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal)); }, num_repetitions), n);
+  report("pnbd_PAlive",   time_ms([&](){ return(clv::pnbd_PAlive(r, s, vX, vT_x, vT_cal, vAlpha_i, vBeta_i)); }, num_repetitions), n);
+  report("pnbd_CET",      time_ms([&](){ return(clv::pnbd_CET(r, s, 10, vX, vT_cal, vAlpha_i, vBeta_i, vPAlive)); }, num_repetitions), n);
+  report("pnbd_DERT_ind", time_ms([&](){ return(clv::pnbd_DERT_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal, 0.001)); }, num_repetitions), n);
+
+  // BG/NBD
+  const double r_bg = 0.24;
+  const arma::vec vAlpha_bg = 4.41 * vOnes, vA_i = 0.79 * vOnes, vB_i = 2.43 * vOnes;
+  report("bgnbd_LL_ind",  time_ms([&](){ return(clv::bgnbd_LL_ind(r_bg, vAlpha_bg, vA_i, vB_i, vX, vT_x, vT_cal)); }, num_repetitions), n);
+  report("bgnbd_PAlive",  time_ms([&](){ return(clv::bgnbd_PAlive(r_bg, vAlpha_bg, vA_i, vB_i, vX, vT_x, vT_cal)); }, num_repetitions), n);
+  report("bgnbd_CET",     time_ms([&](){ return(clv::bgnbd_CET(r_bg, vAlpha_bg, vA_i, vB_i, 10, vX, vT_x, vT_cal)); }, num_repetitions), n);
+
+  // GGompertz/NBD
+  const double b = 0.0001;
+  report("ggomnbd_LL_ind", time_ms([&](){ return(clv::ggomnbd_LL_ind(r, b, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal)); }, num_repetitions), n);
+  report("ggomnbd_PAlive", time_ms([&](){ return(clv::ggomnbd_PAlive(r, b, s, vX, vT_x, vT_cal, vAlpha_i, vBeta_i)); }, num_repetitions), n);
+  report("ggomnbd_CET",    time_ms([&](){ return(clv::ggomnbd_CET(r, b, s, 10, vX, vT_x, vT_cal, vAlpha_i, vBeta_i)); }, num_repetitions), n);
+
+  // Gamma-Gamma
+  report("gg_LL_ind",     time_ms([&](){ return(clv::gg_LL_ind(6.25, 3.74, 15.44, vX, vM_x)); }, num_repetitions), n);
+
+  return(0);
+}
@@ -0,0 +1,61 @@
+#include <math.h>
+#include "bgnbd.h"
+#include "clv_vectorized.h"
+
+namespace clv{
+
+// beta_ratio := B(a, b) / B(x, y)
+static arma::vec beta_ratio(const arma::vec& a, const arma::vec& b, const arma::vec& x, const arma::vec& y){
+  return(arma::exp(arma::lgamma(a) + arma::lgamma(b) - arma::lgamma(a + b) - arma::lgamma(x) - arma::lgamma(y) + arma::lgamma(x+y)));
+}
+
+arma::vec bgnbd_LL_ind(const double r,
+                       const arma::vec& vAlpha_i,
+                       const arma::vec& vA_i,
+                       const arma::vec& vB_i,
+                       const arma::vec& vX,
+                       const arma::vec& vT_x,
+                       const arma::vec& vT_cal){
+  const unsigned int n = vX.n_elem;
+
+  arma::vec vA(n), vB(n), vBetaRatio(n);
+
+  vA = r * arma::log(vAlpha_i) + arma::lgamma(r + vX) - std::lgamma(r) - (r + vX) % arma::log(vAlpha_i + vT_x);
+
+  vB = beta_ratio(vA_i, (vB_i+vX), vA_i, vB_i) % clv::vec_pow((vAlpha_i + vT_x)/(vAlpha_i + vT_cal), (r + vX)) + ((vX > 0)) % beta_ratio(vA_i + 1 , (vB_i + vX - 1), vA_i, vB_i);
+
+  arma::vec vLL = vA + arma::log(vB);
+
+  return(vLL);
+}
+
+arma::vec bgnbd_PAlive(const double r,
+                       const arma::vec& vAlpha_i,
+                       const arma::vec& vA_i,
+                       const arma::vec& vB_i,
+                       const arma::vec& vX,
+                       const arma::vec& vT_x,
+                       const arma::vec& vT_cal){
+  arma::vec n_term1 = (vA_i/(vB_i + vX - 1)) % clv::vec_pow((vAlpha_i + vT_cal)/(vAlpha_i + vT_x), (r+vX));
+
+  return (1 / (1 + (vX > 0) % n_term1));
+}
+
+arma::vec bgnbd_CET(const double r,
+                    const arma::vec& vAlpha_i,
+                    const arma::vec& vA_i,
+                    const arma::vec& vB_i,
+                    const double dPeriods,
+                    const arma::vec& vX,
+                    const arma::vec& vT_x,
+                    const arma::vec& vT_cal){
+  arma::vec term1 = ((vA_i + vB_i + vX - 1) / (vA_i - 1));
+
+  arma::vec term2 = 1 - clv::vec_pow((vAlpha_i + vT_cal)/(vAlpha_i + vT_cal + dPeriods), (r + vX)) % clv::vec_hyp2F1((r + vX), (vB_i + vX), (vA_i + vB_i + vX - 1), dPeriods / (vAlpha_i + vT_cal + dPeriods));
+
+  arma::vec term3 = 1 + (vX > 0) % (vA_i /(vB_i + vX - 1)) % clv::vec_pow((vAlpha_i + vT_cal)/(vAlpha_i + vT_x), (r + vX));
+
+  return term1 % term2 / term3;
+}
+
+}
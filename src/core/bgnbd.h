@@ -0,0 +1,45 @@
+#ifndef CLV_CORE_BGNBD_HPP
+#define CLV_CORE_BGNBD_HPP
+
+#include "clv_arma.h"
+
+namespace clv{
+
+// BG/NBD
+//    All kernels take the model param r on the original scale and every customer's
+//    alpha_i, a_i and b_i (ie alpha_0, a_0, b_0 adjusted by covariates).
+
+// bgnbd_LL_ind
+//    Individual LogLikelihood of every customer
+arma::vec bgnbd_LL_ind(const double r,
+                       const arma::vec& vAlpha_i,
+                       const arma::vec& vA_i,
+                       const arma::vec& vB_i,
+                       const arma::vec& vX,
+                       const arma::vec& vT_x,
+                       const arma::vec& vT_cal);
+
+// bgnbd_PAlive
+//    Probability of every customer to be alive at the end of the estimation period
+arma::vec bgnbd_PAlive(const double r,
+                       const arma::vec& vAlpha_i,
+                       const arma::vec& vA_i,
+                       const arma::vec& vB_i,
+                       const arma::vec& vX,
+                       const arma::vec& vT_x,
+                       const arma::vec& vT_cal);
+
+// bgnbd_CET
+//    Conditional expected transactions in the dPeriods after the estimation period
+arma::vec bgnbd_CET(const double r,
+                    const arma::vec& vAlpha_i,
+                    const arma::vec& vA_i,
+                    const arma::vec& vB_i,
+                    const double dPeriods,
+                    const arma::vec& vX,
+                    const arma::vec& vT_x,
+                    const arma::vec& vT_cal);
+
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef CLV_ARMA_HPP
+#define CLV_ARMA_HPP
+
+// Armadillo for the core kernels
+//    Built as part of the R package, Armadillo has to come from RcppArmadillo which configures it for R
+//    (ie printing, RNG). The standalone core library (see CMakeLists.txt) defines CLV_CORE_STANDALONE
+//    and uses Armadillo directly, without any R headers.
+#ifdef CLV_CORE_STANDALONE
+#include <armadillo>
+#else
+#include <RcppArmadillo.h>
+#endif
+
+#endif
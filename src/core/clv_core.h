@@ -0,0 +1,20 @@
+#ifndef CLV_CORE_HPP
+#define CLV_CORE_HPP
+
+// CLVTools core
+//    The model kernels without any R dependency: LogLikelihood, PAlive, CET, DERT and expectation
+//    of all latent attrition models, the Gamma-Gamma LogLikelihood and the special functions they use.
+//    They only need Armadillo and GSL and are shared by the R package (thin Rcpp wrappers in src/)
+//    and the standalone core library (see CMakeLists.txt) to embed in other C++ applications.
+//
+//    All kernels are in namespace clv and take the params per customer, as vectors, after
+//    covariates were applied (see clv::vec_exp_cov).
+
+#include "clv_arma.h"
+#include "clv_vectorized.h"
+#include "pnbd.h"
+#include "bgnbd.h"
+#include "ggomnbd.h"
+#include "gg.h"
+
+#endif
@@ -0,0 +1,81 @@
+#include <math.h>
+#include <string>
+#include <stdexcept>
+#include <gsl/gsl_sf_hyperg.h>
+#include <gsl/gsl_errno.h>
+#include "clv_vectorized.h"
+
+namespace clv{
+
+// vec_hyp2F1 --------------------------------------------------
+//    All params as same-length vectors
+
+arma::vec vec_hyp2F1(const arma::vec& vA, const arma::vec& vB, const arma::vec& vC, const arma::vec& vX){
+
+  // Do not abort in case of error
+  gsl_set_error_handler_off();
+
+  arma::vec vRes(vA);
+  arma::uword n = vA.n_elem;
+
+  for(arma::uword i = 0; i<n; i++)
+    vRes(i) = gsl_sf_hyperg_2F1(vA(i), vB(i), vC(i), vX(i));
+
+  return(vRes);
+}
+
+
+
+// vec_x_hyp1F1 ----------------------------------------------------
+//    a, b:     scalars
+//    X:        vector
+//
+//    hypergeom1F1(double a, double b, double x);
+arma::vec vec_x_hyp1F1(const double a, const double b, const arma::vec& vX){
+
+  // Do not abort in case of error
+  gsl_set_error_handler_off();
+
+  arma::vec vRes(vX);
+
+  arma::uword n = vX.n_elem;
+  for(arma::uword i = 0; i<n; i++)
+    vRes(i) = gsl_sf_hyperg_1F1(a, b, vX(i));
+
+  return(vRes);
+}
+
+
+// vec_pow --------------------------------------------------------
+//    element-by-element pow of the two given vectors
+arma::vec vec_pow(const arma::vec& vA, const arma::vec& vP){
+  arma::vec vRes(vA);
+  arma::vec::const_iterator it_a = vA.begin(), it_p = vP.begin(), it_a_end = vA.end();
+  arma::vec::iterator it_res = vRes.begin();
+
+  while(it_a != it_a_end){
+    (*it_res) = std::pow(*it_a, *it_p);
+    it_a++;
+    it_p++;
+    it_res++;
+  }
+
+  return(vRes);
+}
+
+
+// neg_sum_weighted --------------------------------------------------
+//    Negative sum of the individual LL values to minimize.
+//    Every customer's LL is weighted if weights are given, ie to re-weight a
+//    sample to the population. Unweighted if vWeights is empty.
+double neg_sum_weighted(const arma::vec& vLL, const arma::vec& vWeights){
+  if(vWeights.n_elem == 0)
+    return(-arma::sum(vLL));
+
+  if(vWeights.n_elem != vLL.n_elem)
+    throw std::runtime_error(std::string("There need to be as many weights as customers!"));
+
+  return(-arma::dot(vWeights, vLL));
+}
+
+}
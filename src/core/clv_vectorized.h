@@ -0,0 +1,32 @@
+#ifndef CLV_VEC_HPP
+#define CLV_VEC_HPP
+
+#include "clv_arma.h"
+
+namespace clv{
+// vec_hyp2F1
+//    all inputs as vectors
+arma::vec vec_hyp2F1(const arma::vec& vA, const arma::vec& vB, const arma::vec& vC, const arma::vec& vX);
+
+// vec_x_hyp1F1
+//    X as vector, a, b as scalars
+arma::vec vec_x_hyp1F1(double a, double b, const arma::vec& vX);
+
+arma::vec vec_pow(const arma::vec& vA, const arma::vec& vP);
+
+// neg_sum_weighted
+//    Negative sum of the individual LL values, weighted if vWeights is not empty
+double neg_sum_weighted(const arma::vec& vLL, const arma::vec& vWeights);
+
+// vec_exp_cov
+//    base * exp(sign * mCov * vParams) for every customer (row of mCov)
+//    mCov is either dense (arma::mat) or sparse (arma::sp_mat)
+template<typename TMat>
+arma::vec vec_exp_cov(const double base, const TMat& mCov, const arma::vec& vParams, const double sign){
+  const arma::vec vLinPred = mCov * vParams;
+  return(base * arma::exp(sign * vLinPred));
+}
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#include <math.h>
+#include "gg.h"
+
+namespace clv{
+
+// lbeta := lgamma(a) + lgamma(b) - lgamma(a+b)
+static arma::vec lbeta(const arma::vec& a, const double b){
+  return (arma::lgamma(a) + std::lgamma(b) - arma::lgamma(a+b));
+}
+
+arma::vec gg_LL_ind(const double p,
+                    const double q,
+                    const double gamma,
+                    const arma::vec& vX,
+                    const arma::vec& vM_x){
+
+  // Calculate the likelood for all != 0 values
+  const arma::uvec vNonZero = find((vX != 0.0) && (vM_x != 0.0));
+
+  arma::vec vLL(vX.n_elem, arma::fill::zeros);
+  vLL(vNonZero) = q * log(gamma)
+    + ((p * vX(vNonZero) - 1) % arma::log(vM_x(vNonZero)))
+    + ((p * vX(vNonZero)) % arma::log(vX(vNonZero)))
+    - (p * vX(vNonZero) + q) % arma::log(gamma + vM_x(vNonZero) % vX(vNonZero))
+    - lbeta(p * vX(vNonZero), q);
+
+  return(vLL);
+}
+
+arma::vec gg_spending(const double p,
+                      const double q,
+                      const double gamma,
+                      const arma::vec& vX,
+                      const arma::vec& vM_x){
+  return((gamma + vM_x % vX) * p / (p * vX + q - 1));
+}
+
+}
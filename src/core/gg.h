@@ -0,0 +1,29 @@
+#ifndef CLV_CORE_GG_HPP
+#define CLV_CORE_GG_HPP
+
+#include "clv_arma.h"
+
+namespace clv{
+
+// Gamma-Gamma spending model
+
+// gg_LL_ind
+//    Individual LogLikelihood of every customer for the params p, q, gamma on the original scale.
+//    Customers without repeat transactions or without spending do not contribute and are 0.
+arma::vec gg_LL_ind(const double p,
+                    const double q,
+                    const double gamma,
+                    const arma::vec& vX,
+                    const arma::vec& vM_x);
+
+// gg_spending
+//    Expected mean spending per transaction of every customer, given the observed mean spending
+arma::vec gg_spending(const double p,
+                      const double q,
+                      const double gamma,
+                      const arma::vec& vX,
+                      const arma::vec& vM_x);
+
+}
+
+#endif
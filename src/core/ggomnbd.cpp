@@ -0,0 +1,205 @@
+#include <math.h>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_integration.h>
+#include "ggomnbd.h"
+#include "clv_vectorized.h"
+
+namespace clv{
+
+// Params of the integrands, the same for all integrals
+struct integration_params {
+  double r;
+  double alpha_i;
+  double b;
+  double s;
+  double beta_i;
+  double x_i;
+};
+
+// ggomnbd_integrate
+//    Integral of p_integrationFunction from vLower to vUpper for every customer
+static arma::vec ggomnbd_integrate(const double r,
+                                   const double b,
+                                   const double s,
+                                   const arma::vec& vAlpha_i,
+                                   const arma::vec& vBeta_i,
+                                   const arma::vec& vX,
+                                   double (*const p_integrationFunction)(double, void*),
+                                   const arma::vec& vLower,
+                                   const arma::vec& vUpper){
+  // Do not abort in case of error
+  gsl_set_error_handler_off();
+
+  gsl_integration_workspace *workspace
+    = gsl_integration_workspace_alloc (1000);
+
+  gsl_function integrand;
+  integrand.function = p_integrationFunction;
+
+
+  struct integration_params params_i;
+  params_i.r = r;
+  params_i.b = b;
+  params_i.s = s;
+
+  // Calculate integral for each customer
+  double res, err;
+  const arma::uword n = vAlpha_i.n_elem;
+  arma::vec vRes(n);
+  for(arma::uword i = 0; i<n; i++){
+    // These differ per customer
+    params_i.alpha_i = vAlpha_i(i);
+    params_i.beta_i  = vBeta_i(i);
+    params_i.x_i = vX(i);
+
+    integrand.params = &params_i;
+
+    gsl_integration_qags(&integrand, vLower(i), vUpper(i), 1.0e-8, 1.0e-8, 0, workspace, &res, &err);
+    vRes(i) = res;
+  }
+
+  // Free to not leak when called repeatedly in long-running processes
+  gsl_integration_workspace_free(workspace);
+
+  return(vRes);
+}
+
+static double ggomnbd_LL_integrand(double y, void * p_params){
+  struct integration_params * params = (struct integration_params*)p_params;
+
+  const double r = (params -> r);
+  const double b = (params -> b);
+  const double s = (params -> s);
+  const double beta_i = (params -> beta_i);
+  const double alpha_i = (params -> alpha_i);
+  const double x_i = (params -> x_i);
+
+  return  std::pow(y + alpha_i,  -(r + x_i))
+  * std::pow(beta_i + std::exp( b * y) - 1.0 , -(s + 1.0))
+  * std::exp(b * y);
+}
+
+// integrand <- function(tau)  {tau * exp(b*tau)  *((beta + exp(b*tau) - 1)^(-(s+1)))}
+static double ggomnbd_expectation_integrand(double tau, void * p_params){
+  struct integration_params * params = (struct integration_params*)p_params;
+
+  const double b = (params -> b);
+  const double s = (params -> s);
+  const double beta_i = (params -> beta_i);
+
+  return tau * std::exp(b * tau) * std::pow( beta_i + std::exp(b * tau) - 1.0, -(s+1.0) );
+}
+
+arma::vec ggomnbd_LL_ind(const double r,
+                         const double b,
+                         const double s,
+                         const arma::vec& vAlpha_i,
+                         const arma::vec& vBeta_i,
+                         const arma::vec& vX,
+                         const arma::vec& vT_x,
+                         const arma::vec& vT_cal){
+
+  arma::vec vL1 = arma::lgamma(r + vX) - lgamma(r);
+  arma::vec vL2 = arma::lgamma(r + vX) - lgamma(r);
+
+  vL1 += r * (arma::log(vAlpha_i) - arma::log(vAlpha_i + vT_cal)) + vX % (0.0-arma::log(vAlpha_i + vT_cal)) + s * (arma::log(vBeta_i)-arma::log(vBeta_i-1.0 + arma::exp(b*vT_cal))) ;
+  vL2 += std::log(b) + r *arma::log(vAlpha_i) + log(s) + s * arma::log(vBeta_i);
+
+  const arma::vec vIntegrals = ggomnbd_integrate(r, b, s, vAlpha_i, vBeta_i,
+                                                 vX,
+                                                 &ggomnbd_LL_integrand,
+                                                 vT_x, vT_cal);
+  vL2 += arma::log(vIntegrals);
+
+  // Calculate LL ---------------------------------------------------------------------------
+  // arma::vec vLL = arma::log(arma::exp(vL1) + arma::exp(vL2));
+  // For numerical stability rewrite
+  //  log(exp(a) + exp(b))
+  //            as
+  //  max(a,b) + log(exp(a-max(a,b)) + exp(b-max(a,b)))
+
+  const arma::vec vMaxPart = arma::max(vL1, vL2);
+  const arma::vec vLL = vMaxPart + arma::log(arma::exp(vL1 - vMaxPart) + exp(vL2 - vMaxPart));
+
+  return(vLL);
+}
+
+arma::vec ggomnbd_PAlive(const double r,
+                         const double b,
+                         const double s,
+                         const arma::vec& vX,
+                         const arma::vec& vT_x,
+                         const arma::vec& vT_cal,
+                         const arma::vec& vAlpha_i,
+                         const arma::vec& vBeta_i){
+
+  arma::vec vLL = ggomnbd_LL_ind(r, b ,s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
+
+  const arma::vec vP1 = arma::lgamma(r + vX) - lgamma(r);
+  const arma::vec vP2 = r * arma::log(vAlpha_i/(vAlpha_i + vT_cal)) + vX % arma::log(1/(vAlpha_i + vT_cal)) + s * arma::log(vBeta_i/(vBeta_i - 1 + exp(b * vT_cal)));
+  const arma::vec vP3 = vLL;
+
+  return arma::exp(vP1 + vP2 - vP3);
+
+}
+
+arma::vec ggomnbd_expectation(const double b,
+                              const double s,
+                              // Pass r as vector because needed for CET
+                              const arma::vec& vR,
+                              const arma::vec& vAlpha_i,
+                              const arma::vec& vBeta_i,
+                              const arma::vec& vT_i){
+
+  const arma::vec vF1 = (vR / vAlpha_i);
+  const arma::vec vF2 = arma::pow(vBeta_i / (vBeta_i + arma::exp(b * vT_i)-1), s) % (vT_i);
+  const arma::vec vF3 = b * s * arma::pow(vBeta_i, s);
+
+
+  // r and vX are needed in LL but not in the expectation integral.
+  //  Pass zeros (= vLower)
+  const arma::vec vLower(vBeta_i.n_elem, arma::fill::zeros);
+  const arma::vec vF4 = ggomnbd_integrate(0, b, s, vAlpha_i, vBeta_i,
+                                          vLower, //instead of vX, only zeros
+                                          &ggomnbd_expectation_integrand,
+                                          vLower,
+                                          vT_i);
+
+  return(vF1 % (vF2 + (vF3 % vF4)));
+}
+
+arma::vec ggomnbd_CET(const double r,
+                      const double b,
+                      const double s,
+                      const double dPeriods,
+                      const arma::vec& vX,
+                      const arma::vec& vT_x,
+                      const arma::vec& vT_cal,
+                      const arma::vec& vAlpha_i,
+                      const arma::vec& vBeta_i){
+
+  // Expectation is Formula 20: PAlive()*Expectation()
+  //
+  //  with
+  //    r *    = r + x
+  //    alpha* = alpha + Tcal
+  //    beta*  = beta + exp(b*Tcal) - 1
+  //    t_i    = dPeriods
+
+
+  const arma::vec vPAlive = ggomnbd_PAlive(r,b,s,vX,vT_x,vT_cal,vAlpha_i,vBeta_i);
+
+  const arma::vec vRStar     = r + vX;
+  const arma::vec vAlphaStar = vAlpha_i + vX;
+  const arma::vec vBetaStar  = vBeta_i + arma::exp(b * vT_cal) - 1.0;
+
+  arma::vec vPeriods(vX.n_elem);
+  vPeriods.fill(dPeriods);
+
+  const arma::vec vExpectation = ggomnbd_expectation(b, s, vRStar, vAlphaStar, vBetaStar, vPeriods);
+
+
+  return(vPAlive % vExpectation);
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef CLV_CORE_GGOMNBD_HPP
+#define CLV_CORE_GGOMNBD_HPP
+
+#include "clv_arma.h"
+
+namespace clv{
+
+// GGompertz/NBD
+//    All kernels take the model params r, b, s on the original scale and every customer's
+//    alpha_i and beta_i (ie alpha_0 or beta_0 adjusted by covariates).
+//    The integrals are solved numerically with GSL, separately for every customer.
+
+// ggomnbd_LL_ind
+//    Individual LogLikelihood of every customer
+arma::vec ggomnbd_LL_ind(const double r,
+                         const double b,
+                         const double s,
+                         const arma::vec& vAlpha_i,
+                         const arma::vec& vBeta_i,
+                         const arma::vec& vX,
+                         const arma::vec& vT_x,
+                         const arma::vec& vT_cal);
+
+// ggomnbd_PAlive
+//    Probability of every customer to be alive at the end of the estimation period
+arma::vec ggomnbd_PAlive(const double r,
+                         const double b,
+                         const double s,
+                         const arma::vec& vX,
+                         const arma::vec& vT_x,
+                         const arma::vec& vT_cal,
+                         const arma::vec& vAlpha_i,
+                         const arma::vec& vBeta_i);
+
+// ggomnbd_expectation
+//    Unconditional expected transactions in (0, vT_i] since the customer came alive.
+//    r is given per customer because the CET uses it with r + x
+arma::vec ggomnbd_expectation(const double b,
+                              const double s,
+                              const arma::vec& vR,
+                              const arma::vec& vAlpha_i,
+                              const arma::vec& vBeta_i,
+                              const arma::vec& vT_i);
+
+// ggomnbd_CET
+//    Conditional expected transactions in the dPeriods after the estimation period
+arma::vec ggomnbd_CET(const double r,
+                      const double b,
+                      const double s,
+                      const double dPeriods,
+                      const arma::vec& vX,
+                      const arma::vec& vT_x,
+                      const arma::vec& vT_cal,
+                      const arma::vec& vAlpha_i,
+                      const arma::vec& vBeta_i);
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+#include <math.h>
+#include "pnbd.h"
+#include "clv_vectorized.h"
+
+namespace clv{
+
+arma::vec pnbd_LL_ind(const double r,
+                      const double s,
+                      const arma::vec& vAlpha_i,
+                      const arma::vec& vBeta_i,
+                      const arma::vec& vX,
+                      const arma::vec& vT_x,
+                      const arma::vec& vT_cal)
+{
+
+  const unsigned int n = vX.n_elem;
+
+
+  // Param2: s+1 or r+x
+  //  save indices as used again
+  arma::uvec uvAlphaBetaFindRes = find(vAlpha_i < vBeta_i);
+  arma::vec vParam2(n);
+  vParam2.fill((s+1));
+  vParam2(uvAlphaBetaFindRes) = (r + vX(uvAlphaBetaFindRes));
+  // MaxAB
+  arma::vec vMaxAB(vAlpha_i);
+  vMaxAB(uvAlphaBetaFindRes) = vBeta_i(uvAlphaBetaFindRes);
+
+
+  // Distinguish between case abs(alpha_i - beta_i) == 0 and != 0
+  arma::vec vABabs = arma::abs((vAlpha_i - vBeta_i));
+  arma::uvec uvLLFind1 = find(vABabs != 0.0) ;
+  arma::uvec uvLLFind2 = find(vABabs == 0.0);
+
+  arma::vec vF1(n), vF2(n), vPartF(n);
+
+  // Calculate Part F for case vABabs != 0 --------------------------------------------------
+  vF1(uvLLFind1) = clv::vec_hyp2F1(r + s + vX(uvLLFind1),
+      vParam2(uvLLFind1),
+      r + s + vX(uvLLFind1) + 1,
+      vABabs(uvLLFind1) / (vMaxAB(uvLLFind1) + vT_x(uvLLFind1)));
+
+  vF2(uvLLFind1) = clv::vec_hyp2F1(r + s + vX(uvLLFind1),
+      vParam2(uvLLFind1),
+      r + s + vX(uvLLFind1) + 1,
+      vABabs(uvLLFind1)/(vMaxAB(uvLLFind1) + vT_cal(uvLLFind1)));
+
+  vF2(uvLLFind1) %= clv::vec_pow((vMaxAB(uvLLFind1) + vT_x(uvLLFind1))/(vMaxAB(uvLLFind1) + vT_cal(uvLLFind1)),
+      r + s + vX(uvLLFind1));
+
+  vPartF(uvLLFind1) = -(r + s + vX(uvLLFind1)) % arma::log(vMaxAB(uvLLFind1) + vT_x(uvLLFind1)) + arma::log(vF1(uvLLFind1) - vF2(uvLLFind1));
+
+
+
+  // Calculate Part F for case vABabs == 0 --------------------------------------------------
+  vF1(uvLLFind2) = (-1 * (r + s + vX(uvLLFind2))) % arma::log(vMaxAB(uvLLFind2) + vT_x(uvLLFind2));
+
+  vF2(uvLLFind2) = (vMaxAB(uvLLFind2) + vT_x(uvLLFind2)) / (vMaxAB(uvLLFind2) + vT_cal(uvLLFind2));
+  vF2(uvLLFind2) %= clv::vec_pow(vF2(uvLLFind2), r + s + vX(uvLLFind2));
+  vF2(uvLLFind2) = log(1 - vF2(uvLLFind2));
+
+  vPartF(uvLLFind2) = vF1(uvLLFind2) + vF2(uvLLFind2);
+
+
+
+  // Calculate LL ---------------------------------------------------------------------------
+  // For numerical stability rewrite
+  //  log(exp(a) + exp(b))
+  //            as
+  //  max(a,b) + log(exp(a-max(a,b)) + exp(b-max(a,b)))
+  //
+  // There still can be problems with vX as then vPart1 gets too large (lgamma(vX))
+
+  arma::vec vPart1 = r * log(vAlpha_i) + s * log(vBeta_i) - std::lgamma(r) + arma::lgamma(r + vX);
+  arma::vec vPart2 = -(r + vX) % arma::log(vAlpha_i + vT_cal) - s * arma::log(vBeta_i + vT_cal);
+  arma::vec vPart3 = log(s) - arma::log(r + s + vX) + vPartF;
+
+  arma::vec vMaxPart23 = arma::max(vPart2, vPart3);
+  arma::vec vLL = vPart1 + (vMaxPart23 + arma::log(arma::exp(vPart2 - vMaxPart23) +
+    arma::exp(vPart3 - vMaxPart23)));
+
+  return (vLL);
+}
+
+arma::vec pnbd_PAlive( const double r,
+                       const double s,
+                       const arma::vec& vX,
+                       const arma::vec& vT_x,
+                       const arma::vec& vT_cal,
+                       const arma::vec& vAlpha_i,
+                       const arma::vec& vBeta_i){
+
+  const arma::vec vLL = pnbd_LL_ind(r,
+                                    s,
+                                    vAlpha_i,
+                                    vBeta_i,
+                                    vX,
+                                    vT_x,
+                                    vT_cal);
+
+  const arma::vec vF1 = arma::lgamma(r+vX) - std::lgamma(r) + r * (arma::log(vAlpha_i) - arma::log(vAlpha_i + vT_cal)) +
+    vX % (-arma::log(vAlpha_i + vT_cal)) + s*(arma::log(vBeta_i) - arma::log(vBeta_i+vT_cal));
+
+  const arma::vec vLogPAlive = vF1 - vLL;
+
+  return(arma::exp(vLogPAlive));
+}
+
+arma::vec pnbd_CET(const double r,
+                   const double s,
+                   const double dPeriods,
+                   const arma::vec& vX,
+                   const arma::vec& vT_cal,
+                   const arma::vec& vAlpha_i,
+                   const arma::vec& vBeta_i,
+                   const arma::vec& vPAlive){
+
+  const arma::vec vP1 = (r + vX) % (vBeta_i + vT_cal) / ((vAlpha_i + vT_cal) * (s-1));
+  const arma::vec vP2 = (1 - arma::pow((vBeta_i + vT_cal) / (vBeta_i + vT_cal + dPeriods), (s-1)));
+  const arma::vec vP3 = vPAlive;
+
+  // eval is needed as evaluation could be delayed!
+  return (vP1 % vP2 % vP3).eval();
+}
+
+arma::vec pnbd_DERT_ind(const double r,
+                        const double s,
+                        const arma::vec& vAlpha_i,
+                        const arma::vec& vBeta_i,
+                        const arma::vec& vX,
+                        const arma::vec& vT_x,
+                        const arma::vec& vT_cal,
+                        const double continuous_discount_factor){
+
+
+  // Calculate LL ----------------------------------------------------
+  //  Calculate value for every customer
+  arma::vec vLL = pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
+
+  arma::vec vZ = continuous_discount_factor * (vBeta_i + vT_cal);
+
+  arma::vec vPart1 = (arma::pow(vZ, 1-s) / (s-1))  % clv::vec_x_hyp1F1(1, 2-s, vZ);
+  arma::vec vPart2 = std::tgamma(1-s) * clv::vec_x_hyp1F1(s, s, vZ);
+  //
+  arma::vec vTerm = vPart1 + vPart2;
+
+  arma::vec vDERT = arma::exp(
+    r * arma::log(vAlpha_i)
+    + s * arma::log(vBeta_i)
+    + (s-1) * log(continuous_discount_factor)
+    + arma::lgamma(r + vX + 1)
+    + arma::log(vTerm)
+    - std::lgamma(r)
+    - (r + vX + 1) % arma::log(vAlpha_i + vT_cal)
+    - vLL); // dont log as not exp()ed when receiving from pnbd_LL_ind!
+
+    return vDERT;
+}
+
+}
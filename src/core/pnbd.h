@@ -0,0 +1,56 @@
+#ifndef CLV_CORE_PNBD_HPP
+#define CLV_CORE_PNBD_HPP
+
+#include "clv_arma.h"
+
+namespace clv{
+
+// Pareto/NBD
+//    All kernels take the model params r, s on the original scale and every customer's
+//    alpha_i and beta_i (ie alpha_0 or beta_0 adjusted by covariates).
+
+// pnbd_LL_ind
+//    Individual LogLikelihood of every customer
+arma::vec pnbd_LL_ind(const double r,
+                      const double s,
+                      const arma::vec& vAlpha_i,
+                      const arma::vec& vBeta_i,
+                      const arma::vec& vX,
+                      const arma::vec& vT_x,
+                      const arma::vec& vT_cal);
+
+// pnbd_PAlive
+//    Probability of every customer to be alive at the end of the estimation period
+arma::vec pnbd_PAlive(const double r,
+                      const double s,
+                      const arma::vec& vX,
+                      const arma::vec& vT_x,
+                      const arma::vec& vT_cal,
+                      const arma::vec& vAlpha_i,
+                      const arma::vec& vBeta_i);
+
+// pnbd_CET
+//    Conditional expected transactions in the dPeriods after the estimation period, given PAlive
+arma::vec pnbd_CET(const double r,
+                   const double s,
+                   const double dPeriods,
+                   const arma::vec& vX,
+                   const arma::vec& vT_cal,
+                   const arma::vec& vAlpha_i,
+                   const arma::vec& vBeta_i,
+                   const arma::vec& vPAlive);
+
+// pnbd_DERT_ind
+//    Discounted expected residual transactions of every customer
+arma::vec pnbd_DERT_ind(const double r,
+                        const double s,
+                        const arma::vec& vAlpha_i,
+                        const arma::vec& vBeta_i,
+                        const arma::vec& vX,
+                        const arma::vec& vT_x,
+                        const arma::vec& vT_cal,
+                        const double continuous_discount_factor);
+
+}
+
+#endif
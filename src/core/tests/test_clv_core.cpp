@@ -0,0 +1,156 @@
+// Unit tests of the core kernels, without R
+//    Run with ctest after building with CMakeLists.txt. Returns non-zero if any check fails.
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "clv_core.h"
+
+static int num_failed = 0;
+
+#define CLV_CHECK(cond)                                                          \
+  do{                                                                            \
+    if(!(cond)){                                                                 \
+      std::cerr << __FILE__ << ":" << __LINE__ << " failed: " #cond << std::endl; \
+      num_failed++;                                                              \
+    }                                                                            \
+  }while(0)
+
+static bool all_near(const arma::vec& vA, const arma::vec& vB, const double tol){
+  return(vA.n_elem == vB.n_elem && arma::all(arma::abs(vA - vB) <= tol * (1 + arma::abs(vB))));
+}
+
+static bool all_finite_prob(const arma::vec& vP){
+  return(vP.is_finite() && arma::all(vP > 0) && arma::all(vP <= 1 + 1e-9));
+}
+
+// Customers as in the CDNOW data, some without repeat transactions
+static const arma::vec vX     = {2, 1, 0, 14, 5, 0};
+static const arma::vec vT_x   = {30.43, 1.71, 0, 35.86, 20.0, 0};
+static const arma::vec vT_cal = {38.86, 38.86, 38.86, 38.71, 36.0, 20.0};
+
+// Same value for every customer
+static arma::vec rep(const double value){
+  arma::vec vRes(vX.n_elem);
+  vRes.fill(value);
+  return(vRes);
+}
+
+static void test_vectorized(){
+  const arma::vec vA = {0.5, 2, 3.3}, vP = {2, -1, 0.5};
+  CLV_CHECK(all_near(clv::vec_pow(vA, vP), arma::vec({0.25, 0.5, std::sqrt(3.3)}), 1e-14));
+
+  // 2F1(1, 1; 2; z) = -log(1-z) / z
+  const arma::vec vZ = {0.1, 0.5, 0.9};
+  const arma::vec vOnes(3, arma::fill::ones);
+  CLV_CHECK(all_near(clv::vec_hyp2F1(vOnes, vOnes, 2 * vOnes, vZ), -arma::log(1 - vZ) / vZ, 1e-10));
+
+  // 1F1(a; a; x) = exp(x)
+  CLV_CHECK(all_near(clv::vec_x_hyp1F1(2.5, 2.5, vZ), arma::exp(vZ), 1e-10));
+
+  const arma::vec vLL = {-1, -2, -3}, vW = {1, 0.5, 2};
+  CLV_CHECK(clv::neg_sum_weighted(vLL, arma::vec()) == 6);
+  CLV_CHECK(std::abs(clv::neg_sum_weighted(vLL, vW) - 8) < 1e-14);
+  bool thrown = false;
+  try{ clv::neg_sum_weighted(vLL, arma::vec({1, 2})); }catch(const std::runtime_error&){ thrown = true; }
+  CLV_CHECK(thrown);
+
+  const arma::mat mCov = {{1, 0}, {0, 2}, {1, 1}};
+  const arma::vec vParams = {0.5, -0.25};
+  CLV_CHECK(all_near(clv::vec_exp_cov(3.0, mCov, vParams, -1), 3.0 * arma::exp(-mCov * vParams), 1e-14));
+  CLV_CHECK(all_near(clv::vec_exp_cov(3.0, arma::sp_mat(mCov), vParams, -1), 3.0 * arma::exp(-mCov * vParams), 1e-14));
+}
+
+static void test_pnbd(){
+  const double r = 0.55, s = 0.61;
+  const arma::vec vAlpha_i = rep(10.58), vBeta_i = rep(11.67);
+
+  const arma::vec vLL = clv::pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
+  CLV_CHECK(vLL.is_finite() && arma::all(vLL < 0));
+
+  // alpha_i == beta_i is a separate case which has to be continuous with the general one
+  const arma::vec vLL_equal = clv::pnbd_LL_ind(r, s, vAlpha_i, vAlpha_i, vX, vT_x, vT_cal);
+  const arma::vec vLL_near  = clv::pnbd_LL_ind(r, s, vAlpha_i, vAlpha_i * (1 + 1e-9), vX, vT_x, vT_cal);
+  CLV_CHECK(all_near(vLL_equal, vLL_near, 1e-6));
+
+  const arma::vec vPAlive = clv::pnbd_PAlive(r, s, vX, vT_x, vT_cal, vAlpha_i, vBeta_i);
+  CLV_CHECK(all_finite_prob(vPAlive));
+
+  const arma::vec vCET_10 = clv::pnbd_CET(r, s, 10, vX, vT_cal, vAlpha_i, vBeta_i, vPAlive);
+  const arma::vec vCET_20 = clv::pnbd_CET(r, s, 20, vX, vT_cal, vAlpha_i, vBeta_i, vPAlive);
+  CLV_CHECK(vCET_10.is_finite() && arma::all(vCET_10 > 0) && arma::all(vCET_20 > vCET_10));
+
+  const arma::vec vDERT = clv::pnbd_DERT_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal, 0.001);
+  CLV_CHECK(vDERT.is_finite() && arma::all(vDERT > 0));
+}
+
+static void test_bgnbd(){
+  const double r = 0.24, alpha = 4.41, a = 0.79, b = 2.43;
+  const arma::vec vAlpha_i = rep(alpha);
+  const arma::vec vA_i = rep(a), vB_i = rep(b);
+
+  // Without repeat transactions: L = (alpha / (alpha + T))^r
+  const arma::vec vLL = clv::bgnbd_LL_ind(r, vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal);
+  CLV_CHECK(vLL.is_finite() && arma::all(vLL < 0));
+  CLV_CHECK(std::abs(vLL(2) - r * std::log(alpha / (alpha + vT_cal(2)))) < 1e-12);
+
+  const arma::vec vPAlive = clv::bgnbd_PAlive(r, vAlpha_i, vA_i, vB_i, vX, vT_x, vT_cal);
+  CLV_CHECK(all_finite_prob(vPAlive));
+  CLV_CHECK(vPAlive(2) == 1 && vPAlive(5) == 1);
+
+  const arma::vec vCET_10 = clv::bgnbd_CET(r, vAlpha_i, vA_i, vB_i, 10, vX, vT_x, vT_cal);
+  const arma::vec vCET_20 = clv::bgnbd_CET(r, vAlpha_i, vA_i, vB_i, 20, vX, vT_x, vT_cal);
+  CLV_CHECK(vCET_10.is_finite() && arma::all(vCET_10 > 0) && arma::all(vCET_20 > vCET_10));
+}
+
+static void test_ggomnbd(){
+  const double r = 0.55, b = 0.0001, s = 0.61;
+  const arma::vec vAlpha_i = rep(10.58), vBeta_i = rep(11.67);
+
+  const arma::vec vLL = clv::ggomnbd_LL_ind(r, b, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
+  CLV_CHECK(vLL.is_finite() && arma::all(vLL < 0));
+
+  const arma::vec vPAlive = clv::ggomnbd_PAlive(r, b, s, vX, vT_x, vT_cal, vAlpha_i, vBeta_i);
+  CLV_CHECK(all_finite_prob(vPAlive));
+
+  const arma::vec vR = rep(r);
+  const arma::vec vExp_10 = clv::ggomnbd_expectation(b, s, vR, vAlpha_i, vBeta_i, rep(10));
+  const arma::vec vExp_20 = clv::ggomnbd_expectation(b, s, vR, vAlpha_i, vBeta_i, rep(20));
+  CLV_CHECK(vExp_10.is_finite() && arma::all(vExp_10 > 0) && arma::all(vExp_20 > vExp_10));
+
+  const arma::vec vCET = clv::ggomnbd_CET(r, b, s, 10, vX, vT_x, vT_cal, vAlpha_i, vBeta_i);
+  CLV_CHECK(vCET.is_finite() && arma::all(vCET > 0));
+}
+
+static void test_gg(){
+  const double p = 6.25, q = 3.74, gamma = 15.44;
+  const arma::vec vM_x = {35.5, 20, 0, 50.1, 0, 0};
+
+  const arma::vec vLL = clv::gg_LL_ind(p, q, gamma, vX, vM_x);
+  CLV_CHECK(vLL(2) == 0 && vLL(4) == 0 && vLL(5) == 0);
+
+  // Single customer by hand
+  const double x = vX(0), m = vM_x(0);
+  const double ll = q * std::log(gamma) + (p*x - 1) * std::log(m) + p*x * std::log(x) - (p*x + q) * std::log(gamma + m*x)
+    - (std::lgamma(p*x) + std::lgamma(q) - std::lgamma(p*x + q));
+  CLV_CHECK(std::abs(vLL(0) - ll) < 1e-10);
+
+  // Expected spending is the weighted mean of the population and the customer's mean spending
+  const arma::vec vSpending = clv::gg_spending(p, q, gamma, vX, vM_x);
+  CLV_CHECK(std::abs(vSpending(0) - (gamma + m*x) * p / (p*x + q - 1)) < 1e-10);
+  CLV_CHECK(std::abs(vSpending(2) - gamma * p / (q - 1)) < 1e-10);
+}
+
+int main(){
+  test_vectorized();
+  test_pnbd();
+  test_bgnbd();
+  test_ggomnbd();
+  test_gg();
+
+  if(num_failed > 0){
+    std::cerr << num_failed << " check(s) failed" << std::endl;
+    return(1);
+  }
+  std::cout << "All checks passed" << std::endl;
+  return(0);
+}
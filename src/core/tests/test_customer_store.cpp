@@ -0,0 +1,114 @@
+// Unit tests of the customer state store of clvstream
+//    Run with ctest after building with CMakeLists.txt. Returns non-zero if any check fails.
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include "clv_core.h"
+#include "customer_store.h"
+
+static int num_failed = 0;
+
+#define CLV_CHECK(cond)                                                          \
+  do{                                                                            \
+    if(!(cond)){                                                                 \
+      std::cerr << __FILE__ << ":" << __LINE__ << " failed: " #cond << std::endl; \
+      num_failed++;                                                              \
+    }                                                                            \
+  }while(0)
+
+static bool near(const double a, const double b){
+  return(std::abs(a - b) <= 1e-12 * (1 + std::abs(b)));
+}
+
+// Pareto/NBD with spending, as estimated on the CDNOW data
+static clv::ScoreParams pnbd_params(){
+  clv::ScoreParams params;
+  params.model = "pnbd";
+  params.r = 0.55; params.alpha = 10.58; params.s = 0.61; params.beta = 11.67;
+  params.a = params.b = 0;
+  params.has_spending = true;
+  params.p = 6.25; params.q = 3.74; params.gamma = 15.44;
+  return(params);
+}
+
+static void test_add_transaction(){
+  clv::CustomerStore store(pnbd_params(), 10, 0.1);
+
+  // First transaction is no repeat transaction, two at the same time count once
+  store.add_transaction("A", 1, 20);
+  store.add_transaction("A", 3, 10);
+  store.add_transaction("A", 3, 5);
+  const clv::CustomerScore score = store.add_transaction("A", 6, 30);
+
+  const clv::CustomerState& customer = store.state("A");
+  CLV_CHECK(store.size() == 1);
+  CLV_CHECK(customer.x == 2 && customer.first == 1 && customer.last == 6);
+  CLV_CHECK(near(customer.spending, 65));
+
+  // Same as scoring the CBS of this customer. Spending is the mean of 20, 10+5 and 30
+  const arma::vec vX = {2}, vT_x = {5}, vT_cal = {5}, vAlpha_i = {10.58}, vBeta_i = {11.67}, vM_x = {65.0 / 3};
+  const arma::vec vPAlive = clv::pnbd_PAlive(0.55, 0.61, vX, vT_x, vT_cal, vAlpha_i, vBeta_i);
+  CLV_CHECK(near(score.PAlive, vPAlive(0)));
+  CLV_CHECK(near(score.CET, clv::pnbd_CET(0.55, 0.61, 10, vX, vT_cal, vAlpha_i, vBeta_i, vPAlive)(0)));
+  CLV_CHECK(near(score.DERT, clv::pnbd_DERT_ind(0.55, 0.61, vAlpha_i, vBeta_i, vX, vT_x, vT_cal, 0.1)(0)));
+  CLV_CHECK(near(score.spending, clv::gg_spending(6.25, 3.74, 15.44, vX, vM_x)(0)));
+  CLV_CHECK(near(score.CLV, score.DERT * score.spending));
+
+  // Inactivity lowers PAlive
+  CLV_CHECK(store.score("A", 30).PAlive < score.PAlive);
+
+  bool has_thrown = false;
+  try{ store.add_transaction("A", 5, 10); }catch(const std::runtime_error&){ has_thrown = true; }
+  CLV_CHECK(has_thrown);
+
+  has_thrown = false;
+  try{ store.score("B", 10); }catch(const std::out_of_range&){ has_thrown = true; }
+  CLV_CHECK(has_thrown);
+}
+
+static void test_covariates(){
+  clv::ScoreParams params = pnbd_params();
+  params.names_cov_life  = {"gender"};
+  params.names_cov_trans = {"gender"};
+  params.vCovParams_life  = {0.5};
+  params.vCovParams_trans = {-0.2};
+
+  clv::CustomerStore store(params, 10, 0.1);
+  store.set_covariates("A", arma::vec({1}), arma::vec({1}));
+  store.add_transaction("A", 0, 10);
+  CLV_CHECK(near(store.state("A").alpha_i, 10.58 * std::exp(0.2)));
+  CLV_CHECK(near(store.state("A").beta_i, 11.67 * std::exp(-0.5)));
+}
+
+static void test_snapshot(){
+  clv::CustomerStore store(pnbd_params(), 10, 0.1);
+  store.add_transaction("A", 1, 20);
+  store.add_transaction("A", 4.25, 12.5);
+  store.add_transaction("B", 2, 7);
+
+  const std::string path = "test_customer_store_snapshot.csv";
+  store.write_snapshot(path);
+
+  clv::CustomerStore restored(pnbd_params(), 10, 0.1);
+  restored.read_snapshot(path);
+  std::remove(path.c_str());
+
+  CLV_CHECK(restored.size() == 2);
+  CLV_CHECK(restored.state("A").x == 1 && restored.state("A").last == 4.25 && restored.state("A").spending == 32.5);
+  CLV_CHECK(restored.score("A", 10).PAlive == store.score("A", 10).PAlive);
+  CLV_CHECK(restored.score("B", 10).CET == store.score("B", 10).CET);
+}
+
+int main(){
+  test_add_transaction();
+  test_covariates();
+  test_snapshot();
+
+  if(num_failed > 0){
+    std::cerr << num_failed << " check(s) failed" << std::endl;
+    return(1);
+  }
+  std::cout << "All checks passed" << std::endl;
+  return(0);
+}
@@ -0,0 +1,103 @@
+// Unit tests of the lookup of the scores on the lattice of integer periods
+//    Run with ctest after building with CMakeLists.txt. Returns non-zero if any check fails.
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "score_lookup.h"
+#include "scoring.h"
+
+static int num_failed = 0;
+
+#define CLV_CHECK(cond)                                                          \
+  do{                                                                            \
+    if(!(cond)){                                                                 \
+      std::cerr << __FILE__ << ":" << __LINE__ << " failed: " #cond << std::endl; \
+      num_failed++;                                                              \
+    }                                                                            \
+  }while(0)
+
+static bool near(const double a, const double b, const double tol){
+  return(std::abs(a - b) <= tol * (1 + std::abs(b)));
+}
+
+// As estimated on the CDNOW data
+static clv::ScoreParams model_params(const std::string& model){
+  clv::ScoreParams params;
+  params.model = model;
+  params.r = 0.55; params.alpha = 10.58; params.s = 0.61; params.beta = 11.67;
+  params.a = params.b = 0;
+  if(model == "bgnbd"){
+    params.r = 0.24; params.alpha = 4.41; params.a = 0.79; params.b = 2.43;
+  }
+  params.has_spending = false;
+  params.p = params.q = params.gamma = 0;
+  return(params);
+}
+
+// Scores of a single customer with the model
+static void score_one(const clv::ScoreParams& params, const double x, const double t_x, const double T_cal,
+                      double& PAlive, double& CET, double& DERT){
+  const arma::mat mNoCov(1, 0);
+  arma::vec vPAlive, vCET, vDERT;
+  clv::score_customers(params, 10, 0.1, arma::vec({x}), arma::vec({t_x}), arma::vec({T_cal}),
+                       clv::individual_params(params, mNoCov, mNoCov), vPAlive, vCET, vDERT);
+  PAlive = vPAlive(0);
+  CET    = vCET(0);
+  DERT   = vDERT(0);
+}
+
+static void test_lattice(const std::string& model){
+  const clv::ScoreParams params = model_params(model);
+  const clv::ScoreLookup exact(params, 10, 0.1, 5, 20, 1, false, 2);
+  const clv::ScoreLookup interpolated(params, 10, 0.1, 5, 20, 1, true, 2);
+
+  double PAlive, CET, DERT, PAlive_model, CET_model, DERT_model;
+
+  // On the lattice: Same as the model
+  const double customers[4][3] = {{0, 0, 20}, {2, 7, 15}, {5, 20, 20}, {3, 1, 10}};
+  for(int i = 0; i < 4; i++){
+    const double x = customers[i][0], t_x = customers[i][1], T_cal = customers[i][2];
+    score_one(params, x, t_x, T_cal, PAlive_model, CET_model, DERT_model);
+    CLV_CHECK(exact.lookup(x, t_x, T_cal, PAlive, CET, DERT));
+    CLV_CHECK(near(PAlive, PAlive_model, 1e-12) && near(CET, CET_model, 1e-12) && near(DERT, DERT_model, 1e-12));
+  }
+
+  // Between lattice points: Only with interpolate and close to the model
+  CLV_CHECK(!exact.lookup(2, 7.5, 15.5, PAlive, CET, DERT));
+  CLV_CHECK(interpolated.lookup(2, 7.5, 15.5, PAlive, CET, DERT));
+  score_one(params, 2, 7.5, 15.5, PAlive_model, CET_model, DERT_model);
+  CLV_CHECK(near(PAlive, PAlive_model, 1e-2) && near(CET, CET_model, 1e-2) && near(DERT, DERT_model, 1e-2));
+
+  // Next to t.x = T.cal
+  CLV_CHECK(interpolated.lookup(4, 12.5, 12.75, PAlive, CET, DERT));
+  score_one(params, 4, 12.5, 12.75, PAlive_model, CET_model, DERT_model);
+  CLV_CHECK(near(PAlive, PAlive_model, 1e-2) && near(CET, CET_model, 1e-2));
+
+  // Outside of the lattice
+  CLV_CHECK(!interpolated.lookup(6, 10, 20, PAlive, CET, DERT));
+  CLV_CHECK(!interpolated.lookup(2.5, 10, 20, PAlive, CET, DERT));
+  CLV_CHECK(!interpolated.lookup(2, 10, 20.5, PAlive, CET, DERT));
+}
+
+static void test_covariates(){
+  clv::ScoreParams params = model_params("pnbd");
+  params.names_cov_life  = {"gender"};
+  params.vCovParams_life = {0.5};
+
+  bool has_thrown = false;
+  try{ clv::ScoreLookup lookup(params, 10, 0.1, 5, 20, 1, false, 1); }catch(const std::runtime_error&){ has_thrown = true; }
+  CLV_CHECK(has_thrown);
+}
+
+int main(){
+  test_lattice("pnbd");
+  test_lattice("bgnbd");
+  test_covariates();
+
+  if(num_failed > 0){
+    std::cerr << num_failed << " check(s) failed" << std::endl;
+    return(1);
+  }
+  std::cout << "All checks passed" << std::endl;
+  return(0);
+}
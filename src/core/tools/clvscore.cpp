@@ -0,0 +1,264 @@
+// clvscore: Score the customers of a CBS with the params of a fitted model
+//
+//    clvscore --params coef.txt --input cbs.csv --periods 52 [--output scores.csv]
+//             [--format csv|bin] [--discount 0.1] [--chunk-size 100000] [--threads 1]
+//             [--lookup-x 50 --lookup-T 104 [--lookup-step 1] [--interpolate no]]
+//
+// Writes Id, PAlive, CET, DERT and, if the params include p, q and gamma, predicted.Spending
+// and predicted.CLV for every customer, as predict() does in R.
+// The CBS is read and scored in chunks so that it does not have to fit into memory.
+// With --lookup-x and --lookup-T, the scores of models without covariates are precomputed on the
+// lattice of integer periods and customers on it are looked up instead of scored (see ScoreLookup).
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "clv_core.h"
+#include "clvscore_io.h"
+#include "score_lookup.h"
+#include "scoring.h"
+
+struct ScoreOptions{
+  std::string path_params, path_input, path_output;
+  bool is_binary;
+  double periods, discount;
+  arma::uword chunk_size;
+  int num_threads;
+
+  // Lookup of the scores on the lattice of x, t.x and T.cal (only if max_x >= 0)
+  double lookup_max_x, lookup_max_T_cal, lookup_step;
+  bool interpolate;
+};
+
+static void print_usage(std::ostream& out){
+  out << "Usage: clvscore --params FILE --input FILE --periods N [options]\n"
+      << "  --params FILE       fitted params as name=value lines, ie coef() of the fitted model\n"
+      << "  --input FILE        CBS with columns Id, x, t.x, T.cal, Spending and covariates\n"
+      << "  --periods N         number of periods to predict CET for\n"
+      << "  --format csv|bin    format of the CBS (default: from the file extension)\n"
+      << "  --output FILE       where to write the scores (default: stdout)\n"
+      << "  --discount D        continuous discount factor for DERT (default: 0.1)\n"
+      << "  --chunk-size N      customers scored at once (default: 100000)\n"
+      << "  --threads N         threads to score each chunk with (default: 1)\n"
+      << "  --lookup-x N        precompute the scores for x = 0, ..., N and look them up (no covariates)\n"
+      << "  --lookup-T T        ... and for t.x, T.cal = 0, ..., T (required with --lookup-x)\n"
+      << "  --lookup-step S     spacing of t.x and T.cal in the lookup (default: 1)\n"
+      << "  --interpolate yes   interpolate between lookup points instead of scoring (default: no)\n";
+}
+
+static double parse_number(const std::string& option, const std::string& value){
+  char* end = NULL;
+  const double number = std::strtod(value.c_str(), &end);
+  if(value.empty() || *end != '\0')
+    throw std::runtime_error("The value of " + option + " has to be a number!");
+  return(number);
+}
+
+static ScoreOptions parse_options(const std::vector<std::string>& args){
+  ScoreOptions options;
+  options.is_binary   = false;
+  options.periods     = -1;
+  options.discount    = 0.1;
+  options.chunk_size  = 100000;
+  options.num_threads = 1;
+  options.lookup_max_x     = -1;
+  options.lookup_max_T_cal = -1;
+  options.lookup_step      = 1;
+  options.interpolate      = false;
+
+  std::string format;
+  for(std::size_t i = 0; i < args.size(); i += 2){
+    const std::string& option = args[i];
+    if(i + 1 >= args.size())
+      throw std::runtime_error("The option " + option + " requires a value!");
+    const std::string& value = args[i + 1];
+
+    if(option == "--params")          options.path_params = value;
+    else if(option == "--input")      options.path_input  = value;
+    else if(option == "--output")     options.path_output = value;
+    else if(option == "--format")     format = value;
+    else if(option == "--periods")    options.periods  = parse_number(option, value);
+    else if(option == "--discount")   options.discount = parse_number(option, value);
+    else if(option == "--chunk-size") options.chunk_size  = static_cast<arma::uword>(parse_number(option, value));
+    else if(option == "--threads")    options.num_threads = static_cast<int>(parse_number(option, value));
+    else if(option == "--lookup-x")   options.lookup_max_x     = parse_number(option, value);
+    else if(option == "--lookup-T")   options.lookup_max_T_cal = parse_number(option, value);
+    else if(option == "--lookup-step") options.lookup_step     = parse_number(option, value);
+    else if(option == "--interpolate"){
+      if(value != "yes" && value != "no")
+        throw std::runtime_error("--interpolate has to be yes or no!");
+      options.interpolate = (value == "yes");
+    }
+    else throw std::runtime_error("Unknown option " + option + "!");
+  }
+
+  if(options.path_params.empty() || options.path_input.empty())
+    throw std::runtime_error("Both --params and --input are required!");
+  if(options.periods < 0)
+    throw std::runtime_error("--periods is required and may not be negative!");
+  if(options.discount < 0)
+    throw std::runtime_error("--discount may not be negative!");
+  if(options.chunk_size < 1 || options.num_threads < 1)
+    throw std::runtime_error("--chunk-size and --threads have to be at least 1!");
+  if((options.lookup_max_x >= 0) != (options.lookup_max_T_cal >= 0))
+    throw std::runtime_error("--lookup-x and --lookup-T are only possible together!");
+
+  if(format.empty()){
+    const std::string& path = options.path_input;
+    format = (path.size() > 4 && path.compare(path.size() - 4, 4, ".bin") == 0) ? "bin" : "csv";
+  }
+  if(format != "csv" && format != "bin")
+    throw std::runtime_error("--format has to be csv or bin!");
+  options.is_binary = (format == "bin");
+
+  return(options);
+}
+
+// Scores of the customers [first, last] of the chunk, in the order of names_scores
+static void score_block(const clv::ScoreParams& params, const ScoreOptions& options, const clv::ScoreLookup* lookup,
+                        const clv::CBSChunk& chunk, const arma::uword first, const arma::uword last, arma::mat& mScores){
+  arma::vec vPAlive(last - first + 1), vCET(last - first + 1), vDERT(last - first + 1);
+
+  // Customers on the lattice are looked up, all others are scored with the model
+  std::vector<arma::uword> to_score;
+  for(arma::uword i = first; i <= last; i++)
+    if(lookup == NULL || !lookup->lookup(chunk.vX(i), chunk.vT_x(i), chunk.vT_cal(i),
+                                         vPAlive(i - first), vCET(i - first), vDERT(i - first)))
+      to_score.push_back(i);
+
+  if(!to_score.empty()){
+    const arma::uvec vIdx = arma::conv_to<arma::uvec>::from(to_score);
+    const arma::vec vX     = chunk.vX(vIdx);
+    const arma::vec vT_x   = chunk.vT_x(vIdx);
+    const arma::vec vT_cal = chunk.vT_cal(vIdx);
+
+    // Individual params from the covariates. Without covariates, the mat has no cols and exp(0)
+    const arma::mat mCov_life  = chunk.mCov_life.rows(vIdx);
+    const arma::mat mCov_trans = chunk.mCov_trans.rows(vIdx);
+    const clv::IndividualParams ind = clv::individual_params(params, mCov_life, mCov_trans);
+
+    arma::vec vPAlive_scored, vCET_scored, vDERT_scored;
+    clv::score_customers(params, options.periods, options.discount, vX, vT_x, vT_cal, ind,
+                         vPAlive_scored, vCET_scored, vDERT_scored);
+    const arma::uvec vPos = vIdx - first;
+    vPAlive(vPos) = vPAlive_scored;
+    vCET(vPos)    = vCET_scored;
+    vDERT(vPos)   = vDERT_scored;
+  }
+
+  mScores.submat(first, 0, last, 0) = vPAlive;
+  mScores.submat(first, 1, last, 1) = vCET;
+  mScores.submat(first, 2, last, 2) = vDERT;
+
+  if(params.has_spending){
+    const arma::vec vSpending = clv::gg_spending(params.p, params.q, params.gamma, chunk.vX.subvec(first, last),
+                                                 chunk.vSpending.subvec(first, last));
+    mScores.submat(first, 3, last, 3) = vSpending;
+    mScores.submat(first, 4, last, 4) = vDERT % vSpending;
+  }
+}
+
+static void score_chunk(const clv::ScoreParams& params, const ScoreOptions& options, const clv::ScoreLookup* lookup,
+                        const clv::CBSChunk& chunk, arma::mat& mScores){
+  const arma::uword n = chunk.size();
+
+  // A block per thread and some more to balance the integration of the GGompertz/NBD
+  const arma::uword num_blocks = std::min<arma::uword>(n, static_cast<arma::uword>(options.num_threads) * 4);
+  const arma::uword block_size = (n + num_blocks - 1) / num_blocks;
+
+  // Exceptions may not leave the parallel region: Keep the first and re-throw after
+  std::string error;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(options.num_threads)
+#endif
+  for(arma::uword k = 0; k < num_blocks; k++){
+    const arma::uword first = k * block_size;
+    const arma::uword last  = std::min(n, first + block_size) - 1;
+    if(first > last)
+      continue;
+    try{
+      score_block(params, options, lookup, chunk, first, last, mScores);
+    }catch(const std::exception& e){
+#ifdef _OPENMP
+      #pragma omp critical
+#endif
+      {
+        if(error.empty())
+          error = e.what();
+      }
+    }
+  }
+
+  if(!error.empty())
+    throw std::runtime_error(error);
+}
+
+int main(int argc, char* argv[]){
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  if(args.empty() || args[0] == "--help" || args[0] == "-h"){
+    print_usage(args.empty() ? std::cerr : std::cout);
+    return(args.empty() ? 1 : 0);
+  }
+
+  try{
+    const ScoreOptions options = parse_options(args);
+    const clv::ScoreParams params = clv::read_score_params(options.path_params);
+
+    std::vector<std::string> names_scores;
+    names_scores.push_back("PAlive");
+    names_scores.push_back("CET");
+    names_scores.push_back("DERT");
+    if(params.has_spending){
+      names_scores.push_back("predicted.Spending");
+      names_scores.push_back("predicted.CLV");
+    }
+
+    std::ofstream file_output;
+    if(!options.path_output.empty()){
+      file_output.open(options.path_output.c_str());
+      if(!file_output)
+        throw std::runtime_error("Cannot open the output " + options.path_output + "!");
+    }
+    std::ostream& out = options.path_output.empty() ? std::cout : file_output;
+
+    std::unique_ptr<clv::ScoreLookup> lookup;
+    if(options.lookup_max_x >= 0)
+      lookup.reset(new clv::ScoreLookup(params, options.periods, options.discount,
+                                        static_cast<arma::uword>(options.lookup_max_x), options.lookup_max_T_cal,
+                                        options.lookup_step, options.interpolate, options.num_threads));
+
+    std::unique_ptr<clv::CBSReader> reader = clv::open_cbs_reader(options.path_input, options.is_binary, params);
+
+    clv::CBSChunk chunk;
+    arma::mat mScores;
+    bool is_first = true;
+    while(reader->next_chunk(options.chunk_size, chunk)){
+      mScores.set_size(chunk.size(), names_scores.size());
+      score_chunk(params, options, lookup.get(), chunk, mScores);
+      clv::write_scores_csv(out, chunk, names_scores, mScores, is_first);
+      is_first = false;
+    }
+
+    // Header also if there are no customers
+    if(is_first)
+      clv::write_scores_csv(out, chunk, names_scores, mScores, true);
+
+    out.flush();
+    if(!out)
+      throw std::runtime_error("Failed to write the scores!");
+  }catch(const std::exception& e){
+    std::cerr << "clvscore: " << e.what() << std::endl;
+    return(1);
+  }
+
+  return(0);
+}
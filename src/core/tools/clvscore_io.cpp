@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include "clvscore_io.h"
+
+namespace clv{
+
+static std::string trim(const std::string& str){
+  const std::string whitespace = " \t\r\n";
+  const std::size_t first = str.find_first_not_of(whitespace);
+  if(first == std::string::npos)
+    return(std::string());
+  return(str.substr(first, str.find_last_not_of(whitespace) - first + 1));
+}
+
+static bool starts_with(const std::string& str, const std::string& prefix){
+  return(str.compare(0, prefix.size(), prefix) == 0);
+}
+
+static double parse_double(const std::string& str, const std::string& what){
+  const std::string trimmed = trim(str);
+  char* end = NULL;
+  const double value = std::strtod(trimmed.c_str(), &end);
+  if(trimmed.empty() || *end != '\0')
+    throw std::runtime_error("Cannot read " + what + ": \"" + str + "\" is not a number!");
+  return(value);
+}
+
+
+// Params ------------------------------------------------------------------------------------------------
+static double required_param(const std::map<std::string, double>& params, const std::string& name, const std::string& model){
+  const std::map<std::string, double>::const_iterator it = params.find(name);
+  if(it == params.end())
+    throw std::runtime_error("The param " + name + " of the " + model + " model is missing!");
+  return(it->second);
+}
+
+ScoreParams read_score_params(const std::string& path){
+  std::ifstream in(path.c_str());
+  if(!in)
+    throw std::runtime_error("Cannot open the params file " + path + "!");
+
+  std::map<std::string, double> model_params;
+  std::vector<double> cov_life, cov_trans;
+  ScoreParams params;
+
+  std::string line;
+  while(std::getline(in, line)){
+    line = trim(line);
+    if(line.empty() || line[0] == '#')
+      continue;
+
+    const std::size_t pos = line.find('=');
+    if(pos == std::string::npos)
+      throw std::runtime_error("Every line in the params file has to be name=value but found \"" + line + "\"!");
+    const std::string name  = trim(line.substr(0, pos));
+    const double      value = parse_double(line.substr(pos + 1), "the param " + name);
+
+    // Correlation does not enter the predictions
+    if(starts_with(name, "Cor("))
+      continue;
+
+    if(starts_with(name, "life.")){
+      params.names_cov_life.push_back(name.substr(5));
+      cov_life.push_back(value);
+    }else if(starts_with(name, "trans.")){
+      params.names_cov_trans.push_back(name.substr(6));
+      cov_trans.push_back(value);
+    }else if(starts_with(name, "constr.")){
+      params.names_cov_life.push_back(name.substr(7));
+      params.names_cov_trans.push_back(name.substr(7));
+      cov_life.push_back(value);
+      cov_trans.push_back(value);
+    }else{
+      const char* known[] = {"r", "alpha", "s", "beta", "a", "b", "p", "q", "gamma"};
+      bool is_known = false;
+      for(std::size_t i = 0; i < sizeof(known) / sizeof(known[0]); i++)
+        is_known = is_known || (name == known[i]);
+      if(!is_known)
+        throw std::runtime_error("Unknown param " + name + " in the params file!");
+      model_params[name] = value;
+    }
+  }
+
+  // Model from the names of its params
+  //    bgnbd: r, alpha, a, b   ggomnbd: r, alpha, b, s, beta   pnbd: r, alpha, s, beta
+  params.r = params.alpha = params.s = params.beta = params.a = params.b = 0;
+  if(model_params.count("a")){
+    params.model = "bgnbd";
+    params.a = required_param(model_params, "a", params.model);
+    params.b = required_param(model_params, "b", params.model);
+  }else{
+    params.model = model_params.count("b") ? "ggomnbd" : "pnbd";
+    params.s    = required_param(model_params, "s", params.model);
+    params.beta = required_param(model_params, "beta", params.model);
+    if(params.model == "ggomnbd")
+      params.b = required_param(model_params, "b", params.model);
+  }
+  params.r     = required_param(model_params, "r", params.model);
+  params.alpha = required_param(model_params, "alpha", params.model);
+
+  params.vCovParams_life  = arma::vec(cov_life);
+  params.vCovParams_trans = arma::vec(cov_trans);
+
+  const int num_spending = model_params.count("p") + model_params.count("q") + model_params.count("gamma");
+  if(num_spending != 0 && num_spending != 3)
+    throw std::runtime_error("All of the spending params p, q and gamma are required to predict spending!");
+  params.has_spending = (num_spending == 3);
+  params.p = params.has_spending ? model_params["p"] : 0;
+  params.q = params.has_spending ? model_params["q"] : 0;
+  params.gamma = params.has_spending ? model_params["gamma"] : 0;
+
+  return(params);
+}
+
+
+// Columns to read -----------------------------------------------------------------------------------------
+//    Id, x, t.x, T.cal, Spending (if needed), covariates life, covariates trans
+static std::vector<std::string> cbs_columns(const ScoreParams& params){
+  std::vector<std::string> names;
+  names.push_back("Id");
+  names.push_back("x");
+  names.push_back("t.x");
+  names.push_back("T.cal");
+  if(params.has_spending)
+    names.push_back("Spending");
+  names.insert(names.end(), params.names_cov_life.begin(), params.names_cov_life.end());
+  names.insert(names.end(), params.names_cov_trans.begin(), params.names_cov_trans.end());
+  return(names);
+}
+
+// Index of every column in the file
+static std::vector<std::size_t> match_columns(const std::vector<std::string>& names_needed, const std::vector<std::string>& names_file){
+  std::vector<std::size_t> indices;
+  for(std::size_t i = 0; i < names_needed.size(); i++){
+    std::size_t j = 0;
+    while(j < names_file.size() && names_file[j] != names_needed[i])
+      j++;
+    if(j == names_file.size())
+      throw std::runtime_error("The CBS has no column " + names_needed[i] + "!");
+    indices.push_back(j);
+  }
+  return(indices);
+}
+
+static void resize_chunk(CBSChunk& chunk, const arma::uword n, const ScoreParams& params){
+  chunk.vIds.resize(n);
+  chunk.vX.set_size(n);
+  chunk.vT_x.set_size(n);
+  chunk.vT_cal.set_size(n);
+  chunk.vSpending.set_size(params.has_spending ? n : 0);
+  chunk.mCov_life.set_size(n, params.names_cov_life.size());
+  chunk.mCov_trans.set_size(n, params.names_cov_trans.size());
+}
+
+// Value of column k (in the order of cbs_columns) of customer i
+static void set_chunk_value(CBSChunk& chunk, const ScoreParams& params, const arma::uword i, std::size_t k, const double value){
+  switch(k){
+    case 1: chunk.vX(i) = value; return;
+    case 2: chunk.vT_x(i) = value; return;
+    case 3: chunk.vT_cal(i) = value; return;
+  }
+  k -= 4;
+  if(params.has_spending){
+    if(k == 0){
+      chunk.vSpending(i) = value;
+      return;
+    }
+    k -= 1;
+  }
+  if(k < chunk.mCov_life.n_cols)
+    chunk.mCov_life(i, k) = value;
+  else
+    chunk.mCov_trans(i, k - chunk.mCov_life.n_cols) = value;
+}
+
+
+// CSV -------------------------------------------------------------------------------------------------------
+static void split_csv_line(const std::string& line, std::vector<std::string>& fields){
+  fields.clear();
+  std::size_t start = 0;
+  while(true){
+    const std::size_t end = line.find(',', start);
+    std::string field = trim(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    if(field.size() >= 2 && field[0] == '"' && field[field.size() - 1] == '"')
+      field = field.substr(1, field.size() - 2);
+    fields.push_back(field);
+    if(end == std::string::npos)
+      break;
+    start = end + 1;
+  }
+}
+
+class CSVReader : public CBSReader{
+public:
+  CSVReader(const std::string& path, const ScoreParams& params)
+    : in(path.c_str()), params(params), line_number(1) {
+    if(!in)
+      throw std::runtime_error("Cannot open the CBS " + path + "!");
+
+    std::string header;
+    if(!std::getline(in, header))
+      throw std::runtime_error("The CBS " + path + " is empty!");
+    split_csv_line(header, fields);
+    indices = match_columns(cbs_columns(params), fields);
+  }
+
+  bool next_chunk(const arma::uword max_rows, CBSChunk& chunk){
+    resize_chunk(chunk, max_rows, params);
+
+    arma::uword n = 0;
+    std::string line;
+    while(n < max_rows && std::getline(in, line)){
+      line_number++;
+      if(trim(line).empty())
+        continue;
+
+      split_csv_line(line, fields);
+      std::ostringstream where;
+      where << "line " << line_number << " of the CBS";
+      for(std::size_t k = 0; k < indices.size(); k++){
+        if(indices[k] >= fields.size())
+          throw std::runtime_error("Too few columns in " + where.str() + "!");
+        if(k == 0)
+          chunk.vIds[n] = fields[indices[k]];
+        else
+          set_chunk_value(chunk, params, n, k, parse_double(fields[indices[k]], where.str()));
+      }
+      n++;
+    }
+
+    if(n < max_rows)
+      resize_chunk(chunk, n, params);
+    return(n > 0);
+  }
+
+private:
+  std::ifstream in;
+  const ScoreParams& params;
+  std::vector<std::size_t> indices;
+  std::vector<std::string> fields;
+  arma::uword line_number;
+};
+
+
+// Binary columnar -------------------------------------------------------------------------------------------
+class BinaryReader : public CBSReader{
+public:
+  BinaryReader(const std::string& path, const ScoreParams& params)
+    : in(path.c_str(), std::ios::binary), params(params), num_rows(0), next_row(0) {
+    if(!in)
+      throw std::runtime_error("Cannot open the CBS " + path + "!");
+
+    char magic[8];
+    std::uint32_t num_cols = 0;
+    read(magic, 8);
+    if(std::memcmp(magic, "CLVCBS01", 8) != 0)
+      throw std::runtime_error("The CBS " + path + " is not a binary CBS file!");
+    read(&num_rows, sizeof(num_rows));
+    read(&num_cols, sizeof(num_cols));
+
+    std::vector<std::string> names(num_cols);
+    std::vector<std::uint8_t> types(num_cols);
+    for(std::uint32_t j = 0; j < num_cols; j++){
+      std::uint32_t len = 0;
+      read(&len, sizeof(len));
+      names[j].resize(len);
+      if(len > 0)
+        read(&names[j][0], len);
+      read(&types[j], sizeof(types[j]));
+    }
+
+    indices = match_columns(cbs_columns(params), names);
+    if(types[indices[0]] != 1)
+      throw std::runtime_error("The Id column of a binary CBS has to be of type int64!");
+    for(std::size_t k = 1; k < indices.size(); k++)
+      if(types[indices[k]] != 0)
+        throw std::runtime_error("The column " + names[indices[k]] + " of a binary CBS has to be of type float64!");
+
+    data_start = in.tellg();
+  }
+
+  bool next_chunk(const arma::uword max_rows, CBSChunk& chunk){
+    const arma::uword n = static_cast<arma::uword>(std::min<std::uint64_t>(max_rows, num_rows - next_row));
+    resize_chunk(chunk, n, params);
+    if(n == 0)
+      return(false);
+
+    // Every column is contiguous: Read the rows of this chunk from each
+    std::vector<std::int64_t> vIds(n);
+    std::vector<double> vValues(n);
+    for(std::size_t k = 0; k < indices.size(); k++){
+      in.seekg(data_start + static_cast<std::streamoff>((indices[k] * num_rows + next_row) * 8));
+      if(k == 0){
+        read(&vIds[0], n * 8);
+        for(arma::uword i = 0; i < n; i++)
+          chunk.vIds[i] = std::to_string(static_cast<long long>(vIds[i]));
+      }else{
+        read(&vValues[0], n * 8);
+        for(arma::uword i = 0; i < n; i++)
+          set_chunk_value(chunk, params, i, k, vValues[i]);
+      }
+    }
+
+    next_row += n;
+    return(true);
+  }
+
+private:
+  void read(void* dest, const std::size_t num_bytes){
+    if(!in.read(static_cast<char*>(dest), num_bytes))
+      throw std::runtime_error("Unexpected end of the binary CBS!");
+  }
+
+  std::ifstream in;
+  const ScoreParams& params;
+  std::vector<std::size_t> indices;
+  std::uint64_t num_rows;
+  std::uint64_t next_row;
+  std::streamoff data_start;
+};
+
+
+std::unique_ptr<CBSReader> open_cbs_reader(const std::string& path, const bool is_binary, const ScoreParams& params){
+  if(is_binary)
+    return(std::unique_ptr<CBSReader>(new BinaryReader(path, params)));
+  return(std::unique_ptr<CBSReader>(new CSVReader(path, params)));
+}
+
+
+// Output ----------------------------------------------------------------------------------------------------
+void write_scores_csv(std::ostream& out, const CBSChunk& chunk, const std::vector<std::string>& names_scores,
+                      const arma::mat& mScores, const bool write_header){
+  std::string buffer;
+  if(write_header){
+    buffer += "Id";
+    for(std::size_t j = 0; j < names_scores.size(); j++)
+      buffer += "," + names_scores[j];
+    buffer += "\n";
+  }
+
+  // Format the whole chunk at once and write it with a single call
+  char number[32];
+  for(arma::uword i = 0; i < mScores.n_rows; i++){
+    buffer += chunk.vIds[i];
+    for(arma::uword j = 0; j < mScores.n_cols; j++){
+      std::snprintf(number, sizeof(number), ",%.17g", mScores(i, j));
+      buffer += number;
+    }
+    buffer += "\n";
+  }
+  out.write(buffer.data(), buffer.size());
+}
+
+}
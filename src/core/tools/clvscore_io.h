@@ -0,0 +1,72 @@
+#ifndef CLV_SCORE_IO_HPP
+#define CLV_SCORE_IO_HPP
+
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "clv_arma.h"
+
+namespace clv{
+
+// ScoreParams
+//    Fitted params on the original scale, as given by coef() of the fitted model:
+//      - model params (ie r, alpha, s, beta). The model is derived from their names
+//      - covariate params prefixed with "life.", "trans." or "constr." (both processes)
+//      - optionally the Gamma-Gamma spending params p, q, gamma
+struct ScoreParams{
+  std::string model;
+  double r, alpha, s, beta, a, b;
+
+  std::vector<std::string> names_cov_life, names_cov_trans;
+  arma::vec vCovParams_life, vCovParams_trans;
+
+  bool has_spending;
+  double p, q, gamma;
+};
+
+// Params from a text file with a "name=value" line per param. Lines starting with # are ignored
+ScoreParams read_score_params(const std::string& path);
+
+// CBSChunk
+//    Consecutive customers of the CBS. The covariate data has a column for every covariate
+//    param, in the same order (life then trans).
+struct CBSChunk{
+  std::vector<std::string> vIds;
+  arma::vec vX, vT_x, vT_cal, vSpending;
+  arma::mat mCov_life, mCov_trans;
+
+  arma::uword size() const { return(vX.n_elem); }
+};
+
+// CBSReader
+//    Reads the CBS chunk by chunk to not hold all customers in memory.
+//    Columns Id, x, t.x, T.cal, Spending (only if needed) and the covariates by name.
+class CBSReader{
+public:
+  virtual ~CBSReader() {}
+
+  // Next at most max_rows customers. False if there are none left
+  virtual bool next_chunk(const arma::uword max_rows, CBSChunk& chunk) = 0;
+};
+
+// CSV with header line, comma-separated
+//
+// Binary columnar file (all little-endian):
+//    char[8]   magic "CLVCBS01"
+//    uint64    number of rows
+//    uint32    number of columns
+//    for every column:  uint32 length of name, char[] name, uint8 type (0: float64, 1: int64)
+//    for every column:  all values of the column, 8 bytes each
+//    The Id column has to be int64, all others float64. Not compressed such that it can be read in chunks.
+std::unique_ptr<CBSReader> open_cbs_reader(const std::string& path, const bool is_binary, const ScoreParams& params);
+
+// Results of a chunk as CSV, with the header before the first chunk
+void write_scores_csv(std::ostream& out, const CBSChunk& chunk, const std::vector<std::string>& names_scores,
+                      const arma::mat& mScores, const bool write_header);
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+// clvstream: Update the scores of customers per incoming transaction
+//
+//    clvstream --params coef.txt --periods 52 [--snapshot states.csv] [--snapshot-every 10000]
+//              [--discount 0.1] [--lookup-x 50 --lookup-T 104 [--lookup-step 1]]
+//
+// Reads transactions as "Id,time,price" lines from stdin and writes a line
+// Id, time, PAlive, CET, DERT (and predicted.Spending, predicted.CLV with spending params)
+// with the customer's updated scores for every transaction to stdout right away.
+// Times are in the time unit of the fitted model, from any common origin.
+// Transactions that cannot be applied are reported on stderr and skipped.
+//
+// With --snapshot, the states of all customers are restored from this file at start (if it
+// exists) and written back every --snapshot-every transactions and at the end of the input.
+// Covariates are not supported because there is no input for them.
+// With --lookup-x and --lookup-T, the scores are interpolated from a precomputed lattice
+// where possible (see ScoreLookup).
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "customer_store.h"
+
+static void print_usage(std::ostream& out){
+  out << "Usage: clvstream --params FILE --periods N [options] < transactions\n"
+      << "  --params FILE         fitted params as name=value lines, ie coef() of the fitted model\n"
+      << "  --periods N           number of periods to predict CET for\n"
+      << "  --discount D          continuous discount factor for DERT (default: 0.1)\n"
+      << "  --snapshot FILE       file to restore the customer states from and to save them to\n"
+      << "  --snapshot-every N    transactions between snapshots (default: 10000)\n"
+      << "  --lookup-x N          precompute the scores for x = 0, ..., N and interpolate them\n"
+      << "  --lookup-T T          ... and for t.x, T.cal = 0, ..., T (required with --lookup-x)\n"
+      << "  --lookup-step S       spacing of t.x and T.cal in the lookup (default: 1)\n";
+}
+
+static double parse_number(const std::string& what, const std::string& value){
+  char* end = NULL;
+  const double number = std::strtod(value.c_str(), &end);
+  if(value.empty() || *end != '\0')
+    throw std::runtime_error("The " + what + " has to be a number!");
+  return(number);
+}
+
+int main(int argc, char* argv[]){
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  if(args.empty() || args[0] == "--help" || args[0] == "-h"){
+    print_usage(args.empty() ? std::cerr : std::cout);
+    return(args.empty() ? 1 : 0);
+  }
+
+  try{
+    std::string path_params, path_snapshot;
+    double periods = -1, discount = 0.1, snapshot_every = 10000;
+    double lookup_max_x = -1, lookup_max_T_cal = -1, lookup_step = 1;
+    for(std::size_t i = 0; i < args.size(); i += 2){
+      const std::string& option = args[i];
+      if(i + 1 >= args.size())
+        throw std::runtime_error("The option " + option + " requires a value!");
+      const std::string& value = args[i + 1];
+
+      if(option == "--params")              path_params = value;
+      else if(option == "--snapshot")       path_snapshot = value;
+      else if(option == "--periods")        periods  = parse_number("value of " + option, value);
+      else if(option == "--discount")       discount = parse_number("value of " + option, value);
+      else if(option == "--snapshot-every") snapshot_every = parse_number("value of " + option, value);
+      else if(option == "--lookup-x")       lookup_max_x     = parse_number("value of " + option, value);
+      else if(option == "--lookup-T")       lookup_max_T_cal = parse_number("value of " + option, value);
+      else if(option == "--lookup-step")    lookup_step      = parse_number("value of " + option, value);
+      else throw std::runtime_error("Unknown option " + option + "!");
+    }
+    if(path_params.empty() || periods < 0)
+      throw std::runtime_error("--params and --periods are required!");
+    if(snapshot_every < 1)
+      throw std::runtime_error("--snapshot-every has to be at least 1!");
+    if((lookup_max_x >= 0) != (lookup_max_T_cal >= 0))
+      throw std::runtime_error("--lookup-x and --lookup-T are only possible together!");
+
+    const clv::ScoreParams params = clv::read_score_params(path_params);
+    if(params.vCovParams_life.n_elem > 0 || params.vCovParams_trans.n_elem > 0)
+      throw std::runtime_error("clvstream does not support models with covariates!");
+
+    clv::CustomerStore store(params, periods, discount);
+
+    // Event times are not on the lattice: Always interpolate
+    std::unique_ptr<clv::ScoreLookup> lookup;
+    if(lookup_max_x >= 0){
+      lookup.reset(new clv::ScoreLookup(params, periods, discount, static_cast<arma::uword>(lookup_max_x),
+                                        lookup_max_T_cal, lookup_step, true, 1));
+      store.set_lookup(lookup.get());
+    }
+    if(!path_snapshot.empty() && std::ifstream(path_snapshot.c_str()))
+      store.read_snapshot(path_snapshot);
+
+    std::cout << "Id,time,PAlive,CET,DERT" << (params.has_spending ? ",predicted.Spending,predicted.CLV" : "") << std::endl;
+
+    std::string line;
+    unsigned long num_since_snapshot = 0;
+    char scores[160];
+    while(std::getline(std::cin, line)){
+      if(line.empty() || line[0] == '#')
+        continue;
+
+      try{
+        const std::size_t pos_time  = line.find(',');
+        const std::size_t pos_price = (pos_time == std::string::npos) ? pos_time : line.find(',', pos_time + 1);
+        if(pos_price == std::string::npos)
+          throw std::runtime_error("a transaction has to be Id,time,price");
+
+        const std::string id = line.substr(0, pos_time);
+        const double time  = parse_number("time", line.substr(pos_time + 1, pos_price - pos_time - 1));
+        const double price = parse_number("price", line.substr(pos_price + 1));
+
+        const clv::CustomerScore score = store.add_transaction(id, time, price);
+        if(params.has_spending)
+          std::snprintf(scores, sizeof(scores), ",%.17g,%.17g,%.17g,%.17g,%.17g,%.17g",
+                        time, score.PAlive, score.CET, score.DERT, score.spending, score.CLV);
+        else
+          std::snprintf(scores, sizeof(scores), ",%.17g,%.17g,%.17g,%.17g", time, score.PAlive, score.CET, score.DERT);
+        // Flush every line for whoever waits for the scores of this transaction
+        std::cout << id << scores << std::endl;
+      }catch(const std::exception& e){
+        std::cerr << "clvstream: skipping \"" << line << "\": " << e.what() << std::endl;
+        continue;
+      }
+
+      if(!path_snapshot.empty() && ++num_since_snapshot >= snapshot_every){
+        store.write_snapshot(path_snapshot);
+        num_since_snapshot = 0;
+      }
+    }
+
+    if(!path_snapshot.empty())
+      store.write_snapshot(path_snapshot);
+  }catch(const std::exception& e){
+    std::cerr << "clvstream: " << e.what() << std::endl;
+    return(1);
+  }
+
+  return(0);
+}
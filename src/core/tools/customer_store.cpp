@@ -0,0 +1,184 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "clv_core.h"
+#include "customer_store.h"
+#include "scoring.h"
+
+namespace clv{
+
+CustomerStore::CustomerStore(const ScoreParams& params, const double periods, const double continuous_discount_factor)
+  : params(params), periods(periods), continuous_discount_factor(continuous_discount_factor), lookup(NULL) {
+  if(periods < 0 || continuous_discount_factor < 0)
+    throw std::runtime_error("The periods and the discount factor may not be negative!");
+}
+
+CustomerState CustomerStore::new_state() const{
+  CustomerState customer;
+  customer.has_transactions = false;
+  customer.first = customer.last = 0;
+  customer.x = customer.spending = 0;
+  customer.alpha_i = params.alpha;
+  customer.beta_i  = params.beta;
+  customer.a_i     = params.a;
+  customer.b_i     = params.b;
+  return(customer);
+}
+
+CustomerScore CustomerStore::add_transaction(const std::string& id, const double time, const double price){
+  std::unordered_map<std::string, CustomerState>::iterator it = states.find(id);
+  if(it == states.end())
+    it = states.insert(std::make_pair(id, new_state())).first;
+  CustomerState& customer = it->second;
+
+  if(!customer.has_transactions){
+    // First transaction: Not a repeat transaction
+    customer.has_transactions = true;
+    customer.first = customer.last = time;
+  }else{
+    if(time < customer.last)
+      throw std::runtime_error("The transactions of customer " + id + " arrive out of order!");
+
+    // Same time as the last transaction: Only add its spending
+    if(time > customer.last){
+      customer.x   += 1;
+      customer.last = time;
+    }
+  }
+  customer.spending += price;
+
+  return(score_state(customer, time));
+}
+
+CustomerScore CustomerStore::score(const std::string& id, const double now) const{
+  const CustomerState& customer = state(id);
+  if(!customer.has_transactions)
+    throw std::runtime_error("The customer " + id + " has no transactions yet!");
+  if(now < customer.last)
+    throw std::runtime_error("Cannot score customer " + id + " before its last transaction!");
+  return(score_state(customer, now));
+}
+
+void CustomerStore::set_covariates(const std::string& id, const arma::vec& vCov_life, const arma::vec& vCov_trans){
+  if(vCov_life.n_elem != params.vCovParams_life.n_elem || vCov_trans.n_elem != params.vCovParams_trans.n_elem)
+    throw std::runtime_error("The covariates of customer " + id + " do not match the covariate params!");
+
+  std::unordered_map<std::string, CustomerState>::iterator it = states.find(id);
+  if(it == states.end())
+    it = states.insert(std::make_pair(id, new_state())).first;
+  CustomerState& customer = it->second;
+
+  // As for the whole CBS, exp() of the linear predictor
+  const double life  = arma::dot(vCov_life, params.vCovParams_life);
+  const double trans = arma::dot(vCov_trans, params.vCovParams_trans);
+  customer.alpha_i = params.alpha * std::exp(-trans);
+  if(params.model == "bgnbd"){
+    customer.a_i = params.a * std::exp(life);
+    customer.b_i = params.b * std::exp(life);
+  }else{
+    customer.beta_i = params.beta * std::exp(-life);
+  }
+}
+
+const CustomerState& CustomerStore::state(const std::string& id) const{
+  const std::unordered_map<std::string, CustomerState>::const_iterator it = states.find(id);
+  if(it == states.end())
+    throw std::out_of_range("There is no customer " + id + "!");
+  return(it->second);
+}
+
+CustomerScore CustomerStore::score_state(const CustomerState& customer, const double now) const{
+  CustomerScore score;
+  const double t_x = customer.last - customer.first, T_cal = now - customer.first;
+
+  // The kernels score many customers at once, here a single one
+  const arma::vec vX = {customer.x};
+  if(lookup == NULL || !lookup->lookup(customer.x, t_x, T_cal, score.PAlive, score.CET, score.DERT)){
+    IndividualParams ind;
+    ind.vAlpha_i = {customer.alpha_i};
+    ind.vBeta_i  = {customer.beta_i};
+    ind.vA_i     = {customer.a_i};
+    ind.vB_i     = {customer.b_i};
+
+    arma::vec vPAlive, vCET, vDERT;
+    score_customers(params, periods, continuous_discount_factor, vX, arma::vec({t_x}), arma::vec({T_cal}), ind,
+                    vPAlive, vCET, vDERT);
+    score.PAlive = vPAlive(0);
+    score.CET    = vCET(0);
+    score.DERT   = vDERT(0);
+  }
+
+  score.spending = score.CLV = 0;
+  if(params.has_spending){
+    // Mean spending per transaction as in the CBS, where those at the same time are summed
+    const arma::vec vM_x = {customer.spending / (customer.x + 1)};
+    score.spending = gg_spending(params.p, params.q, params.gamma, vX, vM_x)(0);
+    score.CLV      = score.DERT * score.spending;
+  }
+  return(score);
+}
+
+
+// Snapshots -------------------------------------------------------------------------------------------------
+static const char* snapshot_header = "Id,has.transactions,first,last,x,spending,alpha.i,beta.i,a.i,b.i";
+
+void CustomerStore::write_snapshot(const std::string& path) const{
+  const std::string path_tmp = path + ".tmp";
+  {
+    std::ofstream out(path_tmp.c_str());
+    if(!out)
+      throw std::runtime_error("Cannot open the snapshot " + path_tmp + "!");
+
+    out << snapshot_header << "\n";
+    char line[256];
+    for(std::unordered_map<std::string, CustomerState>::const_iterator it = states.begin(); it != states.end(); ++it){
+      const CustomerState& c = it->second;
+      std::snprintf(line, sizeof(line), ",%d,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                    c.has_transactions ? 1 : 0, c.first, c.last, c.x, c.spending, c.alpha_i, c.beta_i, c.a_i, c.b_i);
+      out << it->first << line;
+    }
+
+    out.flush();
+    if(!out)
+      throw std::runtime_error("Failed to write the snapshot " + path_tmp + "!");
+  }
+
+  if(std::rename(path_tmp.c_str(), path.c_str()) != 0)
+    throw std::runtime_error("Cannot replace the snapshot " + path + "!");
+}
+
+void CustomerStore::read_snapshot(const std::string& path){
+  std::ifstream in(path.c_str());
+  if(!in)
+    throw std::runtime_error("Cannot open the snapshot " + path + "!");
+
+  std::string line;
+  if(!std::getline(in, line) || line != snapshot_header)
+    throw std::runtime_error("The file " + path + " is not a snapshot of customer states!");
+
+  std::unordered_map<std::string, CustomerState> snapshot;
+  while(std::getline(in, line)){
+    if(line.empty())
+      continue;
+
+    std::istringstream fields(line);
+    std::string id;
+    CustomerState c;
+    int has_transactions = 0;
+    char sep[8];
+    if(!(std::getline(fields, id, ',')
+           >> has_transactions >> sep[0] >> c.first >> sep[1] >> c.last >> sep[2] >> c.x >> sep[3] >> c.spending
+           >> sep[4] >> c.alpha_i >> sep[5] >> c.beta_i >> sep[6] >> c.a_i >> sep[7] >> c.b_i))
+      throw std::runtime_error("Cannot read the line \"" + line + "\" of the snapshot " + path + "!");
+    c.has_transactions = (has_transactions != 0);
+    snapshot[id] = c;
+  }
+
+  states.swap(snapshot);
+}
+
+}
@@ -0,0 +1,76 @@
+#ifndef CLV_CUSTOMER_STORE_HPP
+#define CLV_CUSTOMER_STORE_HPP
+
+#include <string>
+#include <unordered_map>
+#include "clv_arma.h"
+#include "clvscore_io.h"
+#include "score_lookup.h"
+
+namespace clv{
+
+// CustomerState
+//    Sufficient statistics of a customer as in the CBS, kept up to date per transaction.
+//    Times are in the time unit of the fitted model (ie weeks), from any common origin.
+//    As in the CBS, transactions at the same time count as a single transaction and the
+//    first transaction is not a repeat transaction. The spending is the mean over all
+//    transactions, the first included, after summing those at the same time.
+struct CustomerState{
+  bool has_transactions;
+  double first, last;     // time of the first and the last transaction
+  double x;               // number of repeat transactions
+  double spending;        // sum of the spending of all transactions, the first included
+
+  // Individual params from the static covariates (the model params without covariates)
+  double alpha_i, beta_i, a_i, b_i;
+};
+
+struct CustomerScore{
+  double PAlive, CET, DERT;
+  double spending, CLV;   // Only with spending params, 0 otherwise
+};
+
+// CustomerStore
+//    All customers by Id. Every transaction updates its customer in O(1) and re-scores
+//    it with the fitted params, without touching any other customer.
+class CustomerStore{
+public:
+  CustomerStore(const ScoreParams& params, const double periods, const double continuous_discount_factor);
+
+  // Adds a transaction and returns the customer's scores right after it.
+  // Transactions of a customer have to arrive ordered by time.
+  CustomerScore add_transaction(const std::string& id, const double time, const double price);
+
+  // Scores of a customer at time now (ie at the end of the day to find inactive customers)
+  CustomerScore score(const std::string& id, const double now) const;
+
+  // Static covariates in the order of the covariate params of life and trans
+  void set_covariates(const std::string& id, const arma::vec& vCov_life, const arma::vec& vCov_trans);
+
+  // Look up the scores instead of evaluating the model where possible. The lookup has to be
+  // built with the same params and has to outlive the store. NULL to not use a lookup.
+  void set_lookup(const ScoreLookup* lookup){ this->lookup = lookup; }
+
+  bool contains(const std::string& id) const { return(states.count(id) > 0); }
+  const CustomerState& state(const std::string& id) const;
+  std::size_t size() const { return(states.size()); }
+
+  // Snapshot of all states as CSV. Written to a temporary file first and then renamed over
+  // path so that there always is a complete snapshot, also if the process dies while writing.
+  void write_snapshot(const std::string& path) const;
+  // Replaces all states with those of a snapshot
+  void read_snapshot(const std::string& path);
+
+private:
+  CustomerState new_state() const;
+  CustomerScore score_state(const CustomerState& customer, const double now) const;
+
+  const ScoreParams params;
+  const double periods, continuous_discount_factor;
+  std::unordered_map<std::string, CustomerState> states;
+  const ScoreLookup* lookup;
+};
+
+}
+
+#endif
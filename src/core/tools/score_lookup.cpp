@@ -0,0 +1,115 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "score_lookup.h"
+#include "scoring.h"
+
+namespace clv{
+
+ScoreLookup::ScoreLookup(const ScoreParams& params, const double periods, const double continuous_discount_factor,
+                         const arma::uword max_x, const double max_T_cal, const double step, const bool interpolate,
+                         const int num_threads)
+  : step(step), interpolate(interpolate) {
+  if(params.vCovParams_life.n_elem > 0 || params.vCovParams_trans.n_elem > 0)
+    throw std::runtime_error("Lookups are only possible for models without covariates!");
+  if(!(step > 0) || !(max_T_cal >= 0))
+    throw std::runtime_error("The step of the lookup has to be positive and its max T.cal may not be negative!");
+
+  const arma::uword n = static_cast<arma::uword>(std::floor(max_T_cal / step + 1e-9)) + 1;
+  cPAlive.set_size(n, n, max_x + 1);
+  cCET.set_size(n, n, max_x + 1);
+  cDERT.set_size(n, n, max_x + 1);
+
+  // All (t.x, T.cal) of a slice at once, column-major as the slices
+  //    Lattice points with t.x > T.cal do not exist but are needed to interpolate next to
+  //    t.x = T.cal: Use the scores at t.x = T.cal for them
+  const arma::vec vGrid = arma::linspace<arma::vec>(0, (n - 1) * step, n);
+  const arma::vec vT_cal = arma::vectorise(arma::repmat(vGrid.t(), n, 1));
+  const arma::vec vT_x_all = arma::min(arma::vectorise(arma::repmat(vGrid, 1, n)), vT_cal);
+
+  const arma::mat mNoCov(n * n, 0);
+  const IndividualParams ind = individual_params(params, mNoCov, mNoCov);
+
+  // Slices are independent. Errors may not leave the parallel region: Keep the first and re-throw after
+  std::string error;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+#endif
+  for(arma::uword x = 0; x <= max_x; x++){
+    try{
+      // Without repeat transactions, t.x is 0 as in the CBS
+      const arma::vec vT_x = (x == 0) ? arma::zeros<arma::vec>(n * n) : vT_x_all;
+      arma::vec vX(n * n);
+      vX.fill(static_cast<double>(x));
+      arma::vec vPAlive, vCET, vDERT;
+      score_customers(params, periods, continuous_discount_factor, vX, vT_x, vT_cal, ind, vPAlive, vCET, vDERT);
+
+      cPAlive.slice(x) = arma::reshape(vPAlive, n, n);
+      cCET.slice(x)    = arma::reshape(vCET, n, n);
+      cDERT.slice(x)   = arma::reshape(vDERT, n, n);
+    }catch(const std::exception& e){
+#ifdef _OPENMP
+      #pragma omp critical
+#endif
+      {
+        if(error.empty())
+          error = e.what();
+      }
+    }
+  }
+
+  if(!error.empty())
+    throw std::runtime_error(error);
+}
+
+bool ScoreLookup::lattice_pos(const double value, arma::uword& lower, arma::uword& upper, double& weight_upper) const{
+  const double pos = value / step;
+  const double max_pos = static_cast<double>(cPAlive.n_rows - 1);
+  if(!(pos >= -1e-9 && pos <= max_pos + 1e-9))
+    return(false);
+
+  const double nearest = std::round(pos);
+  if(std::abs(pos - nearest) <= 1e-9 * (1 + pos)){
+    lower = upper = static_cast<arma::uword>(nearest);
+    weight_upper = 0;
+    return(true);
+  }
+  if(!interpolate)
+    return(false);
+
+  lower = static_cast<arma::uword>(std::floor(pos));
+  upper = lower + 1;
+  weight_upper = pos - lower;
+  return(true);
+}
+
+bool ScoreLookup::lookup(const double x, const double t_x, const double T_cal, double& PAlive, double& CET, double& DERT) const{
+  if(!(x >= 0 && x <= cPAlive.n_slices - 1) || x != std::floor(x))
+    return(false);
+
+  arma::uword i0, i1, j0, j1;
+  double wi, wj;
+  if(!lattice_pos(t_x, i0, i1, wi) || !lattice_pos(T_cal, j0, j1, wj))
+    return(false);
+
+  const arma::uword k = static_cast<arma::uword>(x);
+  const arma::cube* cubes[3] = {&cPAlive, &cCET, &cDERT};
+  double* results[3] = {&PAlive, &CET, &DERT};
+  for(int c = 0; c < 3; c++){
+    const arma::cube& cube = *cubes[c];
+    const double value = (1 - wi) * (1 - wj) * cube(i0, j0, k) + wi * (1 - wj) * cube(i1, j0, k)
+                       + (1 - wi) * wj * cube(i0, j1, k) + wi * wj * cube(i1, j1, k);
+    // Kernels may fail at single lattice points (ie T.cal = 0): Leave these to the caller
+    if(!std::isfinite(value))
+      return(false);
+    *results[c] = value;
+  }
+  return(true);
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef CLV_SCORE_LOOKUP_HPP
+#define CLV_SCORE_LOOKUP_HPP
+
+#include "clv_arma.h"
+#include "clvscore_io.h"
+
+namespace clv{
+
+// ScoreLookup
+//    PAlive, CET and DERT of a model without covariates, precomputed on the lattice
+//      x = 0, 1, ..., max_x   and   t.x, T.cal = 0, step, 2*step, ..., max_T_cal
+//    With integer periods (ie weekly data and a fixed estimation end), every customer is on the
+//    lattice and scoring is a lookup instead of evaluating the hypergeometric functions or the
+//    integrals. With interpolate, customers between lattice points are scored by bilinear
+//    interpolation in t.x and T.cal (x is always a count).
+//    Memory is 3 * 8 * (max_x + 1) * (max_T_cal / step + 1)^2 bytes.
+//    Only used by the command-line tools (clvscore --lookup-x). predict() in R scores every customer
+//    once, which is cheaper than filling the (max_x + 1) * (max_T_cal / step + 1)^2 lattice unless
+//    far more customers than lattice points are scored with the same params.
+class ScoreLookup{
+public:
+  ScoreLookup(const ScoreParams& params, const double periods, const double continuous_discount_factor,
+              const arma::uword max_x, const double max_T_cal, const double step, const bool interpolate,
+              const int num_threads);
+
+  // False if the customer is not on the lattice (or outside of it, with interpolate)
+  bool lookup(const double x, const double t_x, const double T_cal, double& PAlive, double& CET, double& DERT) const;
+
+private:
+  // Position on the lattice. False if outside of it or, without interpolate, not on it
+  bool lattice_pos(const double value, arma::uword& lower, arma::uword& upper, double& weight_upper) const;
+
+  const double step;
+  const bool interpolate;
+  // Rows t.x, cols T.cal, slices x
+  arma::cube cPAlive, cCET, cDERT;
+};
+
+}
+
+#endif
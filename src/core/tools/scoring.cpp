@@ -0,0 +1,36 @@
+#include "clv_core.h"
+#include "scoring.h"
+
+namespace clv{
+
+IndividualParams individual_params(const ScoreParams& params, const arma::mat& mCov_life, const arma::mat& mCov_trans){
+  IndividualParams ind;
+  ind.vAlpha_i = vec_exp_cov(params.alpha, mCov_trans, params.vCovParams_trans, -1);
+  if(params.model == "bgnbd"){
+    ind.vA_i = vec_exp_cov(params.a, mCov_life, params.vCovParams_life, 1);
+    ind.vB_i = vec_exp_cov(params.b, mCov_life, params.vCovParams_life, 1);
+  }else{
+    ind.vBeta_i = vec_exp_cov(params.beta, mCov_life, params.vCovParams_life, -1);
+  }
+  return(ind);
+}
+
+void score_customers(const ScoreParams& params, const double periods, const double continuous_discount_factor,
+                     const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const IndividualParams& ind,
+                     arma::vec& vPAlive, arma::vec& vCET, arma::vec& vDERT){
+  if(params.model == "bgnbd"){
+    vPAlive = bgnbd_PAlive(params.r, ind.vAlpha_i, ind.vA_i, ind.vB_i, vX, vT_x, vT_cal);
+    vCET    = bgnbd_CET(params.r, ind.vAlpha_i, ind.vA_i, ind.vB_i, periods, vX, vT_x, vT_cal);
+    vDERT   = arma::zeros<arma::vec>(vX.n_elem);
+  }else if(params.model == "pnbd"){
+    vPAlive = pnbd_PAlive(params.r, params.s, vX, vT_x, vT_cal, ind.vAlpha_i, ind.vBeta_i);
+    vCET    = pnbd_CET(params.r, params.s, periods, vX, vT_cal, ind.vAlpha_i, ind.vBeta_i, vPAlive);
+    vDERT   = pnbd_DERT_ind(params.r, params.s, ind.vAlpha_i, ind.vBeta_i, vX, vT_x, vT_cal, continuous_discount_factor);
+  }else{
+    vPAlive = ggomnbd_PAlive(params.r, params.b, params.s, vX, vT_x, vT_cal, ind.vAlpha_i, ind.vBeta_i);
+    vCET    = ggomnbd_CET(params.r, params.b, params.s, periods, vX, vT_x, vT_cal, ind.vAlpha_i, ind.vBeta_i);
+    vDERT   = arma::zeros<arma::vec>(vX.n_elem);
+  }
+}
+
+}
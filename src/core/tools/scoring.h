@@ -0,0 +1,26 @@
+#ifndef CLV_SCORING_HPP
+#define CLV_SCORING_HPP
+
+#include "clv_arma.h"
+#include "clvscore_io.h"
+
+namespace clv{
+
+// IndividualParams
+//    Model params of every customer after applying its static covariates. Only those of the
+//    model are set (alpha and beta for pnbd and ggomnbd, alpha, a and b for bgnbd).
+struct IndividualParams{
+  arma::vec vAlpha_i, vBeta_i, vA_i, vB_i;
+};
+
+// Covariate data with a column per covariate param, no columns without covariates
+IndividualParams individual_params(const ScoreParams& params, const arma::mat& mCov_life, const arma::mat& mCov_trans);
+
+// PAlive, CET and DERT of every customer as in predict(). DERT is 0 for bgnbd and ggomnbd.
+void score_customers(const ScoreParams& params, const double periods, const double continuous_discount_factor,
+                     const arma::vec& vX, const arma::vec& vT_x, const arma::vec& vT_cal, const IndividualParams& ind,
+                     arma::vec& vPAlive, arma::vec& vCET, arma::vec& vDERT);
+
+}
+
+#endif
@@ -1,10 +1,5 @@
 #include <RcppArmadillo.h>
-
-
-// lbeta := lgamma(a) + lgamma(b) - lgamma(a+b)
-arma::vec lbeta(const arma::vec& a, const double b){
-  return (arma::lgamma(a) + std::lgamma(b) - arma::lgamma(a+b));
-}
+#include "core/gg.h"
 
 //' @title Gamma-Gamma: Log-Likelihood Function
 //'
@@ -37,17 +32,8 @@ double gg_LL(const arma::vec& vLogparams,
   const double q = std::exp(vLogparams(1));
   const double gamma = std::exp(vLogparams(2));
 
-  // Calculate the likelood for all != 0 values
-  arma::uvec vNonZero = find((vX != 0.0) && (vM_x != 0.0));
-
-  // arma::vec vLL(vX.n_elem);
-  arma::vec vLL = q * log(gamma)
-    + ((p * vX(vNonZero) - 1) % arma::log(vM_x(vNonZero)))
-    + ((p * vX(vNonZero)) % arma::log(vX(vNonZero)))
-    - (p * vX(vNonZero) + q) % arma::log(gamma + vM_x(vNonZero) % vX(vNonZero))
-    - lbeta(p * vX(vNonZero), q);
+  // Customers without spending do not contribute to the LL (are 0)
+  const arma::vec vLL = clv::gg_LL_ind(p, q, gamma, vX, vM_x);
 
   return -1 * arma::sum(vLL);
 }
-
-
@@ -1,21 +1,8 @@
 #include <RcppArmadillo.h>
 #include <math.h>
-#include "ggomnbd_LL.h"
-#include "ggomnbd_PAlive.h"
-#include "ggomnbd_expectation.h"
-
-
-
-// integrand<-function(omega){omega*exp(b*omega)*(beta_i[i]+exp(b*omega)-1)^-(s+1)}
-double ggomnbd_CET_integrand(double omega, void * p_params){
-  struct integration_params * params = (struct integration_params*)p_params;
-  const double b = (params -> b);
-  const double s = (params -> s);
-  const double beta_i = (params -> beta_i);
-
-  return(omega * std::exp(b * omega) * std::pow(beta_i + std::exp(b * omega) - 1.0, -(s+1.0) ) );
-}
-
+#include "core/ggomnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name ggomnbd_CET
 //'
@@ -33,44 +20,10 @@ double ggomnbd_CET_integrand(double omega, void * p_params){
 //' @templateVar name_params_cov_trans vCovParams_trans
 //' @template template_details_rcppcovmatrix
 //'
+//' @details Both may also be sparse matrices of class \code{dgCMatrix}.
+//'
 //' @template template_references_ggomnbd
 //'
-arma::vec ggomnbd_CET(const double r,
-                      const double b,
-                      const double s,
-                      const double dPeriods,
-                      const arma::vec& vX,
-                      const arma::vec& vT_x,
-                      const arma::vec& vT_cal,
-                      const arma::vec& vAlpha_i,
-                      const arma::vec& vBeta_i){
-
-  // Expectation is Formula 20: PAlive()*Expectation()
-  //
-  //  with
-  //    r *    = r + x
-  //    alpha* = alpha + Tcal
-  //    beta*  = beta + exp(b*Tcal) - 1
-  //    t_i    = dPeriods
-
-
-  const arma::vec vPAlive = ggomnbd_PAlive(r,b,s,vX,vT_x,vT_cal,vAlpha_i,vBeta_i);
-
-  const arma::vec vRStar     = r + vX;
-  const arma::vec vAlphaStar = vAlpha_i + vX;
-  const arma::vec vBetaStar  = vBeta_i + arma::exp(b * vT_cal) - 1.0;
-
-  arma::vec vPeriods(vX.n_elem);
-  vPeriods.fill(dPeriods);
-
-  const arma::vec vExpectation = ggomnbd_expectation(b, s, vRStar, vAlphaStar, vBetaStar, vPeriods);
-
-
-  return(vPAlive % vExpectation);
-}
-
-
-//' @rdname ggomnbd_CET
 // [[Rcpp::export]]
 arma::vec ggomnbd_nocov_CET(const double r,
                             const double alpha_0,
@@ -91,7 +44,7 @@ arma::vec ggomnbd_nocov_CET(const double r,
   vAlpha_i.fill(alpha_0);
   vBeta_i.fill( beta_0);
 
-  return(ggomnbd_CET(r,b,s,dPeriods,vX,vT_x,vT_cal,vAlpha_i, vBeta_i));
+  return(clv::ggomnbd_CET(r,b,s,dPeriods,vX,vT_x,vT_cal,vAlpha_i, vBeta_i));
 }
 
 
@@ -108,8 +61,11 @@ arma::vec ggomnbd_staticcov_CET(const double r,
                                 const arma::vec& vT_cal,
                                 const arma::vec& vCovParams_trans,
                                 const arma::vec& vCovParams_life,
-                                const arma::mat& mCov_life,
-                                const arma::mat& mCov_trans){
+                                SEXP mCov_life,
+                                SEXP mCov_trans){
+  // Dense matrices or dgCMatrix
+  const clv::CovLinPred cov_trans = clv::cov_lin_pred(mCov_trans);
+  const clv::CovLinPred cov_life  = clv::cov_lin_pred(mCov_life);
 
   // Build alpha and beta -------------------------------------------
   //    With static covariates: alpha and beta different per customer
@@ -117,8 +73,8 @@ arma::vec ggomnbd_staticcov_CET(const double r,
   //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
   //    beta_i:  beta0  * exp(-cov.life  * cov.parama.life)
 
-  const arma::vec vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vCovParams_trans));
-  const arma::vec vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vCovParams_life));
+  const arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, cov_trans, vCovParams_trans, -1);
+  const arma::vec vBeta_i  = clv::vec_exp_cov(beta_0, cov_life, vCovParams_life, -1);
 
-  return(ggomnbd_CET(r,b,s,dPeriods,vX,vT_x,vT_cal,vAlpha_i, vBeta_i));
+  return(clv::ggomnbd_CET(r,b,s,dPeriods,vX,vT_x,vT_cal,vAlpha_i, vBeta_i));
 }
@@ -1,67 +1,7 @@
 #include <RcppArmadillo.h>
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_integration.h>
-#include "ggomnbd_LL.h"
-
-arma::vec ggomnbd_integrate(const double r,
-                            const double b,
-                            const double s,
-                            const arma::vec& vAlpha_i,
-                            const arma::vec& vBeta_i,
-                            const arma::vec& vX,
-                            double (*const p_integrationFunction)(double, void*),
-                            const arma::vec& vLower,
-                            const arma::vec& vUpper){
-  // Do not abort in case of error
-  gsl_set_error_handler_off();
-
-  gsl_integration_workspace *workspace
-    = gsl_integration_workspace_alloc (1000);
-
-  gsl_function integrand;
-  integrand.function = p_integrationFunction;
-
-
-  struct integration_params params_i;
-  params_i.r = r;
-  params_i.b = b;
-  params_i.s = s;
-
-  // Calculate integral for each customer
-  double res, err;
-  const arma::uword n = vAlpha_i.n_elem;
-  arma::vec vRes(n);
-  for(arma::uword i = 0; i<n; i++){
-    // These differ per customer
-    params_i.alpha_i = vAlpha_i(i);
-    params_i.beta_i  = vBeta_i(i);
-    params_i.x_i = vX(i);
-
-    integrand.params = &params_i;
-
-    gsl_integration_qags(&integrand, vLower(i), vUpper(i), 1.0e-8, 1.0e-8, 0, workspace, &res, &err);
-    vRes(i) = res;
-  }
-
-  return(vRes);
-}
-
-
-double ggomnbd_LL_integrand(double y, void * p_params){
-  struct integration_params * params = (struct integration_params*)p_params;
-
-  const double r = (params -> r);
-  const double b = (params -> b);
-  const double s = (params -> s);
-  const double beta_i = (params -> beta_i);
-  const double alpha_i = (params -> alpha_i);
-  const double x_i = (params -> x_i);
-
-  return  std::pow(y + alpha_i,  -(r + x_i))
-  * std::pow(beta_i + std::exp( b * y) - 1.0 , -(s + 1.0))
-  * std::exp(b * y);
-}
-
+#include "core/ggomnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name ggomnbd_LL
 //'
@@ -79,41 +19,6 @@ double ggomnbd_LL_integrand(double y, void * p_params){
 //'
 //' @template template_references_ggomnbd
 //'
-arma::vec ggomnbd_LL_ind(const double r,
-                         const double b,
-                         const double s,
-                         const arma::vec& vAlpha_i,
-                         const arma::vec& vBeta_i,
-                         const arma::vec& vX,
-                         const arma::vec& vT_x,
-                         const arma::vec& vT_cal){
-
-  arma::vec vL1 = arma::lgamma(r + vX) - lgamma(r);
-  arma::vec vL2 = arma::lgamma(r + vX) - lgamma(r);
-
-  vL1 += r * (arma::log(vAlpha_i) - arma::log(vAlpha_i + vT_cal)) + vX % (0.0-arma::log(vAlpha_i + vT_cal)) + s * (arma::log(vBeta_i)-arma::log(vBeta_i-1.0 + arma::exp(b*vT_cal))) ;
-  vL2 += std::log(b) + r *arma::log(vAlpha_i) + log(s) + s * arma::log(vBeta_i);
-
-  const arma::vec vIntegrals = ggomnbd_integrate(r, b, s, vAlpha_i, vBeta_i,
-                                                 vX,
-                                                 &ggomnbd_LL_integrand,
-                                                 vT_x, vT_cal);
-  vL2 += arma::log(vIntegrals);
-
-  // Calculate LL ---------------------------------------------------------------------------
-  // arma::vec vLL = arma::log(arma::exp(vL1) + arma::exp(vL2));
-  // For numerical stability rewrite
-  //  log(exp(a) + exp(b))
-  //            as
-  //  max(a,b) + log(exp(a-max(a,b)) + exp(b-max(a,b)))
-
-  const arma::vec vMaxPart = arma::max(vL1, vL2);
-  const arma::vec vLL = vMaxPart + arma::log(arma::exp(vL1 - vMaxPart) + exp(vL2 - vMaxPart));
-
-  return(vLL);
-}
-
-//' @rdname ggomnbd_LL
 // [[Rcpp::export]]
 arma::vec ggomnbd_nocov_LL_ind(const arma::vec& vLogparams,
                                const arma::vec& vX,
@@ -136,7 +41,7 @@ arma::vec ggomnbd_nocov_LL_ind(const arma::vec& vLogparams,
   vAlpha_i.fill(alpha_0);
   vBeta_i.fill(beta_0);
 
-  return(ggomnbd_LL_ind(r, b, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal));
+  return(clv::ggomnbd_LL_ind(r, b, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal));
 }
 
 
@@ -145,7 +50,8 @@ arma::vec ggomnbd_nocov_LL_ind(const arma::vec& vLogparams,
 double ggomnbd_nocov_LL_sum(const arma::vec& vLogparams,
                             const arma::vec& vX,
                             const arma::vec& vT_x,
-                            const arma::vec& vT_cal){
+                            const arma::vec& vT_cal,
+                            const arma::vec& vWeights){
 
 
   arma::vec vLL = ggomnbd_nocov_LL_ind(vLogparams,
@@ -153,21 +59,20 @@ double ggomnbd_nocov_LL_sum(const arma::vec& vLogparams,
                                        vT_x,
                                        vT_cal);
 
-  // accu sums all elements
-  return(-arma::sum(vLL));
+  return(clv::neg_sum_weighted(vLL, vWeights));
 }
 
 
 
 
-//' @rdname ggomnbd_LL
-// [[Rcpp::export]]
-arma::vec ggomnbd_staticcov_LL_ind(const arma::vec& vParams,
-                                   const arma::vec& vX,
-                                   const arma::vec& vT_x,
-                                   const arma::vec& vT_cal,
-                                   const arma::mat& mCov_life,
-                                   const arma::mat& mCov_trans){
+// Static covariates, dense (arma::mat) or sparse (arma::sp_mat) covariate data
+template<typename TMat>
+arma::vec ggomnbd_staticcov_LL_ind_cov(const arma::vec& vParams,
+                                       const arma::vec& vX,
+                                       const arma::vec& vT_x,
+                                       const arma::vec& vT_cal,
+                                       const TMat& mCov_life,
+                                       const TMat& mCov_trans){
 
   // Read out parameters from vParams
   //
@@ -197,10 +102,24 @@ arma::vec ggomnbd_staticcov_LL_ind(const arma::vec& vParams,
   //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
   //    beta_i:  beta0  * exp(-cov.life  * cov.parama.life)
 
-  const arma::vec vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vTrans_params));
-  const arma::vec vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vLife_params));
+  const arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, mCov_trans, vTrans_params, -1);
+  const arma::vec vBeta_i  = clv::vec_exp_cov(beta_0,  mCov_life,  vLife_params,  -1);
+
+  return(clv::ggomnbd_LL_ind(r,b,s,vAlpha_i,vBeta_i,vX,vT_x,vT_cal));
+}
+
 
-  return(ggomnbd_LL_ind(r,b,s,vAlpha_i,vBeta_i,vX,vT_x,vT_cal));
+
+
+//' @rdname ggomnbd_LL
+// [[Rcpp::export]]
+arma::vec ggomnbd_staticcov_LL_ind(const arma::vec& vParams,
+                                   const arma::vec& vX,
+                                   const arma::vec& vT_x,
+                                   const arma::vec& vT_cal,
+                                   const arma::mat& mCov_life,
+                                   const arma::mat& mCov_trans){
+  return(ggomnbd_staticcov_LL_ind_cov(vParams,vX,vT_x,vT_cal,mCov_life,mCov_trans));
 }
 
 
@@ -213,10 +132,72 @@ double ggomnbd_staticcov_LL_sum(const arma::vec& vParams,
                                 const arma::vec& vT_x,
                                 const arma::vec& vT_cal,
                                 const arma::mat& mCov_life,
-                                const arma::mat& mCov_trans){
+                                const arma::mat& mCov_trans,
+                                const arma::vec& vWeights){
 
   // vParams has to be single vector because used by optimizer
-  const arma::vec vLL = ggomnbd_staticcov_LL_ind(vParams,vX,vT_x,vT_cal,mCov_life,mCov_trans);
+  const arma::vec vLL = ggomnbd_staticcov_LL_ind_cov(vParams,vX,vT_x,vT_cal,mCov_life,mCov_trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
+}
+
+
+
+
+//' @rdname ggomnbd_LL
+// [[Rcpp::export]]
+arma::vec ggomnbd_staticcov_sparse_LL_ind(const arma::vec& vParams,
+                                          const arma::vec& vX,
+                                          const arma::vec& vT_x,
+                                          const arma::vec& vT_cal,
+                                          const arma::sp_mat& mCov_life,
+                                          const arma::sp_mat& mCov_trans){
+  return(ggomnbd_staticcov_LL_ind_cov(vParams,vX,vT_x,vT_cal,mCov_life,mCov_trans));
+}
+
+
 
-  return(-arma::sum(vLL));
+
+//' @rdname ggomnbd_LL
+// [[Rcpp::export]]
+double ggomnbd_staticcov_sparse_LL_sum(const arma::vec& vParams,
+                                       const arma::vec& vX,
+                                       const arma::vec& vT_x,
+                                       const arma::vec& vT_cal,
+                                       const arma::sp_mat& mCov_life,
+                                       const arma::sp_mat& mCov_trans,
+                                       const arma::vec& vWeights){
+
+  const arma::vec vLL = ggomnbd_staticcov_LL_ind_cov(vParams,vX,vT_x,vT_cal,mCov_life,mCov_trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
+}
+
+
+//' @rdname ggomnbd_LL
+// [[Rcpp::export]]
+arma::vec ggomnbd_staticcov_cached_LL_ind(const arma::vec& vParams,
+                                          const arma::vec& vX,
+                                          const arma::vec& vT_x,
+                                          const arma::vec& vT_cal,
+                                          SEXP ptrCovCache){
+  const clv::StaticCovCache& cov_cache = clv::staticcov_cache(ptrCovCache);
+  return(ggomnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, cov_cache.life, cov_cache.trans));
+}
+
+
+
+
+//' @rdname ggomnbd_LL
+// [[Rcpp::export]]
+double ggomnbd_staticcov_cached_LL_sum(const arma::vec& vParams,
+                                       const arma::vec& vX,
+                                       const arma::vec& vT_x,
+                                       const arma::vec& vT_cal,
+                                       SEXP ptrCovCache,
+                                       const arma::vec& vWeights){
+  const clv::StaticCovCache& cov_cache = clv::staticcov_cache(ptrCovCache);
+  const arma::vec vLL = ggomnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, cov_cache.life, cov_cache.trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
 }
@@ -1,33 +0,0 @@
-#ifndef GGOMNBD_LL_HPP
-#define GGOMNBD_LL_HPP
-
-arma::vec ggomnbd_LL_ind(const double r,
-                         const double b,
-                         const double s,
-                         const arma::vec & vAlpha_i,
-                         const arma::vec & vBeta_i,
-                         const arma::vec & vX,
-                         const arma::vec & vT_x,
-                         const arma::vec & vT_cal);
-
-
-arma::vec ggomnbd_integrate(const double r,
-                            const double b,
-                            const double s,
-                            const arma::vec& vAlpha_i,
-                            const arma::vec& vBeta_i,
-                            const arma::vec& vX,
-                            double (*const p_integrationFunction)(double, void*),
-                            const arma::vec& vLower,
-                            const arma::vec& vUpper);
-
-struct integration_params {
-  double r;
-  double alpha_i;
-  double b;
-  double s;
-  double beta_i;
-  double x_i;
-};
-
-#endif
@@ -1,6 +1,8 @@
 #include <RcppArmadillo.h>
 #include <math.h>
-#include "ggomnbd_LL.h"
+#include "core/ggomnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name ggomnbd_PAlive
 //'
@@ -17,29 +19,10 @@
 //' @templateVar name_params_cov_trans vCovParams_trans
 //' @template template_details_rcppcovmatrix
 //'
+//' @details Both may also be sparse matrices of class \code{dgCMatrix}.
+//'
 //' @template template_references_ggomnbd
 //'
-arma::vec ggomnbd_PAlive(const double r,
-                         const double b,
-                         const double s,
-                         const arma::vec& vX,
-                         const arma::vec& vT_x,
-                         const arma::vec& vT_cal,
-                         const arma::vec& vAlpha_i,
-                         const arma::vec& vBeta_i){
-
-  arma::vec vLL = ggomnbd_LL_ind(r, b ,s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
-
-  const arma::vec vP1 = arma::lgamma(r + vX) - lgamma(r);
-  const arma::vec vP2 = r * arma::log(vAlpha_i/(vAlpha_i + vT_cal)) + vX % arma::log(1/(vAlpha_i + vT_cal)) + s * arma::log(vBeta_i/(vBeta_i - 1 + exp(b * vT_cal)));
-  const arma::vec vP3 = vLL;
-
-  return arma::exp(vP1 + vP2 - vP3);
-
-}
-
-
-//' @rdname ggomnbd_PAlive
 // [[Rcpp::export]]
 arma::vec ggomnbd_staticcov_PAlive(const double r,
                                    const double alpha_0,
@@ -51,8 +34,11 @@ arma::vec ggomnbd_staticcov_PAlive(const double r,
                                    const arma::vec& vT_cal,
                                    const arma::vec& vCovParams_trans,
                                    const arma::vec& vCovParams_life,
-                                   const arma::mat& mCov_life,
-                                   const arma::mat& mCov_trans){
+                                   SEXP mCov_life,
+                                   SEXP mCov_trans){
+  // Dense matrices or dgCMatrix
+  const clv::CovLinPred cov_trans = clv::cov_lin_pred(mCov_trans);
+  const clv::CovLinPred cov_life  = clv::cov_lin_pred(mCov_life);
 
   // Build alpha and beta -------------------------------------------
   //    With static covariates: alpha and beta different per customer
@@ -60,11 +46,11 @@ arma::vec ggomnbd_staticcov_PAlive(const double r,
   //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
   //    beta_i:  beta0  * exp(-cov.life  * cov.parama.life)
 
-  const arma::vec vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vCovParams_trans));
-  const arma::vec vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vCovParams_life));
+  const arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, cov_trans, vCovParams_trans, -1);
+  const arma::vec vBeta_i  = clv::vec_exp_cov(beta_0, cov_life, vCovParams_life, -1);
 
   // Calculate PAlive ------------------------------------------------
-  return ggomnbd_PAlive(r,b,s,vX,vT_x,vT_cal,vAlpha_i,vBeta_i);
+  return clv::ggomnbd_PAlive(r,b,s,vX,vT_x,vT_cal,vAlpha_i,vBeta_i);
 }
 
 
@@ -91,5 +77,5 @@ arma::vec ggomnbd_nocov_PAlive(const double r,
 
 
   // Calculate PAlive -------------------------------------------------------------
-  return ggomnbd_PAlive(r,b,s,vX,vT_x,vT_cal,vAlpha_i,vBeta_i);
+  return clv::ggomnbd_PAlive(r,b,s,vX,vT_x,vT_cal,vAlpha_i,vBeta_i);
 }
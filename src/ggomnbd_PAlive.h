@@ -1,11 +0,0 @@
-#ifndef GGOMNBD_PALIVE_HPP
-#define GGOMNBD_PALIVE_HPP
-arma::vec ggomnbd_PAlive(const double r,
-                         const double b,
-                         const double s,
-                         const arma::vec& vX,
-                         const arma::vec& vT_x,
-                         const arma::vec& vT_cal,
-                         const arma::vec& vAlpha_i,
-                         const arma::vec& vBeta_i);
-#endif
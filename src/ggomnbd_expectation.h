@@ -1,10 +0,0 @@
-#ifndef GGOMNBD_EXPECTATION_HPP
-#define GGOMNBD_EXPECTATION_HPP
-arma::vec ggomnbd_expectation(const double b,
-                              const double s,
-                              const arma::vec& vR,
-                              const arma::vec& vAlpha_i,
-                              const arma::vec& vBeta_i,
-                              const arma::vec& vT_i);
-
-#endif
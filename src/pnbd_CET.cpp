@@ -2,7 +2,9 @@
 #include <math.h>
 #include <vector>
 
-#include "pnbd_PAlive.h"
+#include "core/pnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name pnbd_CET
 //'
@@ -20,28 +22,10 @@
 //' @templateVar name_params_cov_trans vCovParams_trans
 //' @template template_details_rcppcovmatrix
 //'
+//' @details Both may also be sparse matrices of class \code{dgCMatrix}.
+//'
 //' @template template_references_pnbd
 //'
-arma::vec pnbd_CET(const double r,
-                   const double s,
-                   const double dPeriods,
-                   const arma::vec& vX,
-                   const arma::vec& vT_cal,
-                   const arma::vec& vAlpha_i,
-                   const arma::vec& vBeta_i,
-                   const arma::vec& vPAlive){
-
-  const arma::vec vP1 = (r + vX) % (vBeta_i + vT_cal) / ((vAlpha_i + vT_cal) * (s-1));
-  const arma::vec vP2 = (1 - arma::pow((vBeta_i + vT_cal) / (vBeta_i + vT_cal + dPeriods), (s-1)));
-  const arma::vec vP3 = vPAlive;
-
-  // eval is needed as evaluation could be delayed!
-  return (vP1 % vP2 % vP3).eval();
-}
-
-
-
-//' @rdname pnbd_CET
 // [[Rcpp::export]]
 arma::vec pnbd_nocov_CET(const double r,
                          const double alpha_0,
@@ -63,18 +47,18 @@ arma::vec pnbd_nocov_CET(const double r,
 
 
   // Calculate PAlive -------------------------------------------------------------
-  const arma::vec vPAlive = pnbd_PAlive(r, s,
-                                        vX, vT_x, vT_cal,
-                                        vAlpha_i, vBeta_i);
+  const arma::vec vPAlive = clv::pnbd_PAlive(r, s,
+                                             vX, vT_x, vT_cal,
+                                             vAlpha_i, vBeta_i);
 
 
   // Calculate CET -----------------------------------------------------------------
-  return(pnbd_CET(r,
-                  s,
-                  dPeriods,
-                  vX, vT_cal,
-                  vAlpha_i, vBeta_i,
-                  vPAlive));
+  return(clv::pnbd_CET(r,
+                       s,
+                       dPeriods,
+                       vX, vT_cal,
+                       vAlpha_i, vBeta_i,
+                       vPAlive));
 }
 
 
@@ -93,18 +77,20 @@ arma::vec pnbd_staticcov_CET(const double r,
                              const arma::vec& vT_cal,
                              const arma::vec& vCovParams_trans,
                              const arma::vec& vCovParams_life,
-                             const arma::mat& mCov_trans,
-                             const arma::mat& mCov_life){
-
+                             SEXP mCov_trans,
+                             SEXP mCov_life){
+  // Dense matrices or dgCMatrix
+  const clv::CovLinPred cov_trans = clv::cov_lin_pred(mCov_trans);
+  const clv::CovLinPred cov_life  = clv::cov_lin_pred(mCov_life);
 
-  if(vCovParams_trans.n_elem != mCov_trans.n_cols)
+  if(vCovParams_trans.n_elem != cov_trans.n_cols)
     throw std::out_of_range("Vector of transaction parameters need to have same length as number of columns in transaction covariates!");
 
-  if(vCovParams_life.n_elem != mCov_life.n_cols)
+  if(vCovParams_life.n_elem != cov_life.n_cols)
     throw std::out_of_range("Vector of lifetime parameters need to have same length as number of columns in lifetime covariates!");
 
-  if((vX.n_elem != mCov_trans.n_rows) ||
-     (vX.n_elem != mCov_life.n_rows))
+  if((vX.n_elem != cov_trans.n_rows) ||
+     (vX.n_elem != cov_life.n_rows))
     throw std::out_of_range("There need to be as many covariate rows as customers!");
 
 
@@ -115,21 +101,21 @@ arma::vec pnbd_staticcov_CET(const double r,
 
   arma::vec vAlpha_i(n), vBeta_i(n);
 
-  vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vCovParams_trans));
-  vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vCovParams_life));
+  vAlpha_i = clv::vec_exp_cov(alpha_0, cov_trans, vCovParams_trans, -1);
+  vBeta_i  = clv::vec_exp_cov(beta_0, cov_life, vCovParams_life, -1);
 
 
   // Calculate PAlive -------------------------------------------------------------
-  const arma::vec vPAlive = pnbd_PAlive(r, s,
-                                        vX, vT_x, vT_cal,
-                                        vAlpha_i, vBeta_i);
+  const arma::vec vPAlive = clv::pnbd_PAlive(r, s,
+                                             vX, vT_x, vT_cal,
+                                             vAlpha_i, vBeta_i);
 
 
   // Calculate CET -----------------------------------------------------------------
-  return(pnbd_CET(r, s,
-                  dPeriods,
-                  vX, vT_cal,
-                  vAlpha_i, vBeta_i,
-                  vPAlive));
+  return(clv::pnbd_CET(r, s,
+                       dPeriods,
+                       vX, vT_cal,
+                       vAlpha_i, vBeta_i,
+                       vPAlive));
 }
 
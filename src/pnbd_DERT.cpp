@@ -1,7 +1,8 @@
 #include <RcppArmadillo.h>
 #include <math.h>
-#include "pnbd_LL_ind.h"
-#include "clv_vectorized.h"
+#include "core/pnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name pnbd_DERT
 //'
@@ -26,49 +27,14 @@
 //' @templateVar name_params_cov_trans vCovParams_trans
 //' @template template_details_rcppcovmatrix
 //'
+//' @details Both may also be sparse matrices of class \code{dgCMatrix}.
+//'
 //' @return
 //' Returns a vector with the DERT for each customer.
 //'
 //' @template template_references_pnbd
 //'
 //'
-arma::vec pnbd_DERT_ind(const double r,
-                        const double s,
-                        const arma::vec& vAlpha_i,
-                        const arma::vec& vBeta_i,
-                        const arma::vec& vX,
-                        const arma::vec& vT_x,
-                        const arma::vec& vT_cal,
-                        const double continuous_discount_factor){
-
-
-  // Calculate LL ----------------------------------------------------
-  //  Calculate value for every customer
-  arma::vec vLL = pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
-
-  arma::vec vZ = continuous_discount_factor * (vBeta_i + vT_cal);
-
-  arma::vec vPart1 = (arma::pow(vZ, 1-s) / (s-1))  % clv::vec_x_hyp1F1(1, 2-s, vZ);
-  arma::vec vPart2 = std::tgamma(1-s) * clv::vec_x_hyp1F1(s, s, vZ);
-  //
-  arma::vec vTerm = vPart1 + vPart2;
-
-  arma::vec vDERT = arma::exp(
-    r * arma::log(vAlpha_i)
-    + s * arma::log(vBeta_i)
-    + (s-1) * log(continuous_discount_factor)
-    + arma::lgamma(r + vX + 1)
-    + arma::log(vTerm)
-    - std::lgamma(r)
-    - (r + vX + 1) % arma::log(vAlpha_i + vT_cal)
-    - vLL); // dont log as not exp()ed when receiving from pnbd_LL_ind!
-
-    return vDERT;
-}
-
-
-
-//' @rdname pnbd_DERT
 // [[Rcpp::export]]
 arma::vec pnbd_nocov_DERT(const double r,
                           const double alpha_0,
@@ -90,10 +56,10 @@ arma::vec pnbd_nocov_DERT(const double r,
   vBeta_i.fill(beta_0);
 
   // Calculate DERT -------------------------------------------------
-  return pnbd_DERT_ind(r, s,
-                       vAlpha_i, vBeta_i,
-                       vX, vT_x, vT_cal,
-                       continuous_discount_factor);
+  return clv::pnbd_DERT_ind(r, s,
+                            vAlpha_i, vBeta_i,
+                            vX, vT_x, vT_cal,
+                            continuous_discount_factor);
 }
 
 
@@ -108,22 +74,25 @@ arma::vec pnbd_staticcov_DERT(const double r,
                               const arma::vec& vX,
                               const arma::vec& vT_x,
                               const arma::vec& vT_cal,
-                              const arma::mat& mCov_life,
-                              const arma::mat& mCov_trans,
+                              SEXP mCov_life,
+                              SEXP mCov_trans,
                               const arma::vec& vCovParams_life,
                               const arma::vec& vCovParams_trans){
+  // Dense matrices or dgCMatrix
+  const clv::CovLinPred cov_trans = clv::cov_lin_pred(mCov_trans);
+  const clv::CovLinPred cov_life  = clv::cov_lin_pred(mCov_life);
 
   // Build alpha and beta --------------------------------------------
   //    No covariates: Same alphas, betas for every customer
 
-  arma::vec vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vCovParams_trans));
-  arma::vec vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vCovParams_life));
+  arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, cov_trans, vCovParams_trans, -1);
+  arma::vec vBeta_i  = clv::vec_exp_cov(beta_0, cov_life, vCovParams_life, -1);
 
 
   // Calculate DERT --------------------------------------------------
-  return pnbd_DERT_ind(r, s,
-                       vAlpha_i, vBeta_i,
-                       vX, vT_x, vT_cal,
-                       continuous_discount_factor);
+  return clv::pnbd_DERT_ind(r, s,
+                            vAlpha_i, vBeta_i,
+                            vX, vT_x, vT_cal,
+                            continuous_discount_factor);
 }
 
@@ -1,7 +1,8 @@
 #include <RcppArmadillo.h>
 #include <math.h>
-#include "clv_vectorized.h"
-
+#include "core/pnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name pnbd_LL
 //'
@@ -19,86 +20,6 @@
 //'
 //' @template template_references_pnbd
 //'
-arma::vec pnbd_LL_ind(const double r,
-                      const double s,
-                      const arma::vec& vAlpha_i,
-                      const arma::vec& vBeta_i,
-                      const arma::vec& vX,
-                      const arma::vec& vT_x,
-                      const arma::vec& vT_cal)
-{
-
-  const unsigned int n = vX.n_elem;
-
-
-  // Param2: s+1 or r+x
-  //  save indices as used again
-  arma::uvec uvAlphaBetaFindRes = find(vAlpha_i < vBeta_i);
-  arma::vec vParam2(n);
-  vParam2.fill((s+1));
-  vParam2(uvAlphaBetaFindRes) = (r + vX(uvAlphaBetaFindRes));
-  // MaxAB
-  arma::vec vMaxAB(vAlpha_i);
-  vMaxAB(uvAlphaBetaFindRes) = vBeta_i(uvAlphaBetaFindRes);
-
-
-  // Distinguish between case abs(alpha_i - beta_i) == 0 and != 0
-  arma::vec vABabs = arma::abs((vAlpha_i - vBeta_i));
-  arma::uvec uvLLFind1 = find(vABabs != 0.0) ;
-  arma::uvec uvLLFind2 = find(vABabs == 0.0);
-
-  arma::vec vF1(n), vF2(n), vPartF(n);
-
-  // Calculate Part F for case vABabs != 0 --------------------------------------------------
-  vF1(uvLLFind1) = clv::vec_hyp2F1(r + s + vX(uvLLFind1),
-      vParam2(uvLLFind1),
-      r + s + vX(uvLLFind1) + 1,
-      vABabs(uvLLFind1) / (vMaxAB(uvLLFind1) + vT_x(uvLLFind1)));
-
-  vF2(uvLLFind1) = clv::vec_hyp2F1(r + s + vX(uvLLFind1),
-      vParam2(uvLLFind1),
-      r + s + vX(uvLLFind1) + 1,
-      vABabs(uvLLFind1)/(vMaxAB(uvLLFind1) + vT_cal(uvLLFind1)));
-
-  vF2(uvLLFind1) %= clv::vec_pow((vMaxAB(uvLLFind1) + vT_x(uvLLFind1))/(vMaxAB(uvLLFind1) + vT_cal(uvLLFind1)),
-      r + s + vX(uvLLFind1));
-
-  vPartF(uvLLFind1) = -(r + s + vX(uvLLFind1)) % arma::log(vMaxAB(uvLLFind1) + vT_x(uvLLFind1)) + arma::log(vF1(uvLLFind1) - vF2(uvLLFind1));
-
-
-
-  // Calculate Part F for case vABabs == 0 --------------------------------------------------
-  vF1(uvLLFind2) = (-1 * (r + s + vX(uvLLFind2))) % arma::log(vMaxAB(uvLLFind2) + vT_x(uvLLFind2));
-
-  vF2(uvLLFind2) = (vMaxAB(uvLLFind2) + vT_x(uvLLFind2)) / (vMaxAB(uvLLFind2) + vT_cal(uvLLFind2));
-  vF2(uvLLFind2) %= clv::vec_pow(vF2(uvLLFind2), r + s + vX(uvLLFind2));
-  vF2(uvLLFind2) = log(1 - vF2(uvLLFind2));
-
-  vPartF(uvLLFind2) = vF1(uvLLFind2) + vF2(uvLLFind2);
-
-
-
-  // Calculate LL ---------------------------------------------------------------------------
-  // For numerical stability rewrite
-  //  log(exp(a) + exp(b))
-  //            as
-  //  max(a,b) + log(exp(a-max(a,b)) + exp(b-max(a,b)))
-  //
-  // There still can be problems with vX as then vPart1 gets too large (lgamma(vX))
-
-  arma::vec vPart1 = r * log(vAlpha_i) + s * log(vBeta_i) - std::lgamma(r) + arma::lgamma(r + vX);
-  arma::vec vPart2 = -(r + vX) % arma::log(vAlpha_i + vT_cal) - s * arma::log(vBeta_i + vT_cal);
-  arma::vec vPart3 = log(s) - arma::log(r + s + vX) + vPartF;
-
-  arma::vec vMaxPart23 = arma::max(vPart2, vPart3);
-  arma::vec vLL = vPart1 + (vMaxPart23 + arma::log(arma::exp(vPart2 - vMaxPart23) +
-    arma::exp(vPart3 - vMaxPart23)));
-
-  return (vLL);
-}
-
-
-//' @rdname pnbd_LL
 // [[Rcpp::export]]
 arma::vec pnbd_nocov_LL_ind(const arma::vec& vLogparams,
                             const arma::vec& vX,
@@ -125,7 +46,7 @@ arma::vec pnbd_nocov_LL_ind(const arma::vec& vLogparams,
   // Calculate LL ----------------------------------------------------
   //    Calculate value for every customer
 
-  arma::vec vLL = pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
+  arma::vec vLL = clv::pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
   return(vLL);
 }
 
@@ -135,26 +56,26 @@ arma::vec pnbd_nocov_LL_ind(const arma::vec& vLogparams,
 double pnbd_nocov_LL_sum(const arma::vec& vLogparams,
                          const arma::vec& vX,
                          const arma::vec& vT_x,
-                         const arma::vec& vT_cal){
+                         const arma::vec& vT_cal,
+                         const arma::vec& vWeights){
 
   arma::vec vLL = pnbd_nocov_LL_ind(vLogparams,
                                     vX,
                                     vT_x,
                                     vT_cal);
 
-  // accu sums all elements, indifferent of axis
-  return(-arma::sum(vLL));
+  return(clv::neg_sum_weighted(vLL, vWeights));
 }
 
 
-//' @rdname pnbd_LL
-// [[Rcpp::export]]
-arma::vec pnbd_staticcov_LL_ind(const arma::vec& vParams,
-                                const arma::vec& vX,
-                                const arma::vec& vT_x,
-                                const arma::vec& vT_cal,
-                                const arma::mat& mCov_life,
-                                const arma::mat& mCov_trans){
+// Static covariates, dense (arma::mat) or sparse (arma::sp_mat) covariate data
+template<typename TMat>
+arma::vec pnbd_staticcov_LL_ind_cov(const arma::vec& vParams,
+                                    const arma::vec& vX,
+                                    const arma::vec& vT_x,
+                                    const arma::vec& vT_cal,
+                                    const TMat& mCov_life,
+                                    const TMat& mCov_trans){
 
   const double no_cov_life  = mCov_life.n_cols;
   const double no_cov_trans = mCov_trans.n_cols;
@@ -168,8 +89,6 @@ arma::vec pnbd_staticcov_LL_ind(const arma::vec& vParams,
   const double s        = exp(vModel_log_params(2));
   const double beta_0   = exp(vModel_log_params(3));
 
-  const double n = vX.n_elem;
-
 
 
   // Build alpha and beta --------------------------------------------
@@ -177,19 +96,29 @@ arma::vec pnbd_staticcov_LL_ind(const arma::vec& vParams,
   //
   //    alpha_i: alpha0 * exp(-cov.trans * cov.params.trans)
   //    beta_i:  beta0  * exp(-cov.life  * cov.parama.life)
-  arma::vec vAlpha_i(n), vBeta_i(n);
-
-  vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vTrans_params));
-  vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vLife_params));
+  const arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, mCov_trans, vTrans_params, -1);
+  const arma::vec vBeta_i  = clv::vec_exp_cov(beta_0,  mCov_life,  vLife_params,  -1);
 
   // Calculate LL ----------------------------------------------------
   //    Calculate value for every customer
-  arma::vec vLL = pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
+  arma::vec vLL = clv::pnbd_LL_ind(r, s, vAlpha_i, vBeta_i, vX, vT_x, vT_cal);
 
   return(vLL);
 }
 
 
+//' @rdname pnbd_LL
+// [[Rcpp::export]]
+arma::vec pnbd_staticcov_LL_ind(const arma::vec& vParams,
+                                const arma::vec& vX,
+                                const arma::vec& vT_x,
+                                const arma::vec& vT_cal,
+                                const arma::mat& mCov_life,
+                                const arma::mat& mCov_trans){
+  return(pnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+}
+
+
 
 //' @rdname pnbd_LL
 // [[Rcpp::export]]
@@ -198,16 +127,77 @@ double pnbd_staticcov_LL_sum(const arma::vec& vParams,
                              const arma::vec& vT_x,
                              const arma::vec& vT_cal,
                              const arma::mat& mCov_life,
-                             const arma::mat& mCov_trans){
+                             const arma::mat& mCov_trans,
+                             const arma::vec& vWeights){
 
 
   // Call and return summed values ----------------------------
-  arma::vec vLL = pnbd_staticcov_LL_ind(vParams,
-                                        vX,
-                                        vT_x,
-                                        vT_cal,
-                                        mCov_life,
-                                        mCov_trans);
-
-  return(-arma::sum(vLL));
+  arma::vec vLL = pnbd_staticcov_LL_ind_cov(vParams,
+                                            vX,
+                                            vT_x,
+                                            vT_cal,
+                                            mCov_life,
+                                            mCov_trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
+}
+
+
+//' @rdname pnbd_LL
+// [[Rcpp::export]]
+arma::vec pnbd_staticcov_sparse_LL_ind(const arma::vec& vParams,
+                                       const arma::vec& vX,
+                                       const arma::vec& vT_x,
+                                       const arma::vec& vT_cal,
+                                       const arma::sp_mat& mCov_life,
+                                       const arma::sp_mat& mCov_trans){
+  return(pnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, mCov_life, mCov_trans));
+}
+
+
+//' @rdname pnbd_LL
+// [[Rcpp::export]]
+double pnbd_staticcov_sparse_LL_sum(const arma::vec& vParams,
+                                    const arma::vec& vX,
+                                    const arma::vec& vT_x,
+                                    const arma::vec& vT_cal,
+                                    const arma::sp_mat& mCov_life,
+                                    const arma::sp_mat& mCov_trans,
+                                    const arma::vec& vWeights){
+
+  arma::vec vLL = pnbd_staticcov_LL_ind_cov(vParams,
+                                            vX,
+                                            vT_x,
+                                            vT_cal,
+                                            mCov_life,
+                                            mCov_trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
+}
+
+
+//' @rdname pnbd_LL
+// [[Rcpp::export]]
+arma::vec pnbd_staticcov_cached_LL_ind(const arma::vec& vParams,
+                                       const arma::vec& vX,
+                                       const arma::vec& vT_x,
+                                       const arma::vec& vT_cal,
+                                       SEXP ptrCovCache){
+  const clv::StaticCovCache& cov_cache = clv::staticcov_cache(ptrCovCache);
+  return(pnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, cov_cache.life, cov_cache.trans));
+}
+
+
+//' @rdname pnbd_LL
+// [[Rcpp::export]]
+double pnbd_staticcov_cached_LL_sum(const arma::vec& vParams,
+                                    const arma::vec& vX,
+                                    const arma::vec& vT_x,
+                                    const arma::vec& vT_cal,
+                                    SEXP ptrCovCache,
+                                    const arma::vec& vWeights){
+  const clv::StaticCovCache& cov_cache = clv::staticcov_cache(ptrCovCache);
+  const arma::vec vLL = pnbd_staticcov_LL_ind_cov(vParams, vX, vT_x, vT_cal, cov_cache.life, cov_cache.trans);
+
+  return(clv::neg_sum_weighted(vLL, vWeights));
 }
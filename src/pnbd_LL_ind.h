@@ -1,12 +0,0 @@
-#ifndef PNBD_LL_HPP
-#define PNBD_LL_HPP
-
-arma::vec pnbd_LL_ind( const double r,
-                       const double s,
-                       const arma::vec& vAlpha_i,
-                       const arma::vec& vBeta_i,
-                       const arma::vec& vX,
-                       const arma::vec& vT_x,
-                       const arma::vec& vT_cal);
-
-#endif
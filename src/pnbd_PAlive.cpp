@@ -2,8 +2,9 @@
 #include <math.h>
 #include <vector>
 
-#include "clv_vectorized.h"
-#include "pnbd_LL_ind.h"
+#include "core/pnbd.h"
+#include "core/clv_vectorized.h"
+#include "clv_covcache.h"
 
 //' @name pnbd_PAlive
 //'
@@ -20,35 +21,10 @@
 //' @templateVar name_params_cov_trans vCovParams_trans
 //' @template template_details_rcppcovmatrix
 //'
+//' @details Both may also be sparse matrices of class \code{dgCMatrix}.
+//'
 //' @template template_references_pnbd
 //'
-arma::vec pnbd_PAlive( const double r,
-                       const double s,
-                       const arma::vec& vX,
-                       const arma::vec& vT_x,
-                       const arma::vec& vT_cal,
-                       const arma::vec& vAlpha_i,
-                       const arma::vec& vBeta_i){
-
-  const arma::vec vLL = pnbd_LL_ind(r,
-                                    s,
-                                    vAlpha_i,
-                                    vBeta_i,
-                                    vX,
-                                    vT_x,
-                                    vT_cal);
-
-  const arma::vec vF1 = arma::lgamma(r+vX) - std::lgamma(r) + r * (arma::log(vAlpha_i) - arma::log(vAlpha_i + vT_cal)) +
-    vX % (-arma::log(vAlpha_i + vT_cal)) + s*(arma::log(vBeta_i) - arma::log(vBeta_i+vT_cal));
-
-  const arma::vec vLogPAlive = vF1 - vLL;
-
-  return(arma::exp(vLogPAlive));
-}
-
-
-
-//' @rdname pnbd_PAlive
 // [[Rcpp::export]]
 arma::vec pnbd_nocov_PAlive(const double r,
                             const double alpha_0,
@@ -70,13 +46,13 @@ arma::vec pnbd_nocov_PAlive(const double r,
 
 
   // Calculate PAlive -------------------------------------------------------------
-  return pnbd_PAlive(r,
-                     s,
-                     vX,
-                     vT_x,
-                     vT_cal,
-                     vAlpha_i,
-                     vBeta_i);
+  return clv::pnbd_PAlive(r,
+                          s,
+                          vX,
+                          vT_x,
+                          vT_cal,
+                          vAlpha_i,
+                          vBeta_i);
 }
 
 
@@ -92,33 +68,36 @@ arma::vec pnbd_staticcov_PAlive(const double r,
                                 const arma::vec& vT_cal,
                                 const arma::vec& vCovParams_trans,
                                 const arma::vec& vCovParams_life,
-                                const arma::mat& mCov_trans,
-                                const arma::mat& mCov_life){
+                                SEXP mCov_trans,
+                                SEXP mCov_life){
+  // Dense matrices or dgCMatrix
+  const clv::CovLinPred cov_trans = clv::cov_lin_pred(mCov_trans);
+  const clv::CovLinPred cov_life  = clv::cov_lin_pred(mCov_life);
 
-  if(vCovParams_trans.n_elem != mCov_trans.n_cols)
+  if(vCovParams_trans.n_elem != cov_trans.n_cols)
     throw std::out_of_range("Vector of transaction parameters need to have same length as number of columns in transaction covariates!");
 
-  if(vCovParams_life.n_elem != mCov_life.n_cols)
+  if(vCovParams_life.n_elem != cov_life.n_cols)
     throw std::out_of_range("Vector of lifetime parameters need to have same length as number of columns in lifetime covariates!");
 
-  if((vX.n_elem != mCov_trans.n_rows) ||
-     (vX.n_elem != mCov_life.n_rows))
+  if((vX.n_elem != cov_trans.n_rows) ||
+     (vX.n_elem != cov_life.n_rows))
     throw std::out_of_range("There need to be as many covariate rows as customers!");
 
 
   // Build alpha and beta --------------------------------------------
   //  Static covariates: Different alpha/beta for every customer
 
-  const arma::vec vAlpha_i = alpha_0 * arma::exp(((mCov_trans * (-1)) * vCovParams_trans));
-  const arma::vec vBeta_i  = beta_0  * arma::exp(((mCov_life  * (-1)) * vCovParams_life));
+  const arma::vec vAlpha_i = clv::vec_exp_cov(alpha_0, cov_trans, vCovParams_trans, -1);
+  const arma::vec vBeta_i  = clv::vec_exp_cov(beta_0, cov_life, vCovParams_life, -1);
 
   // Calculate PAlive -------------------------------------------------
-  return pnbd_PAlive(r,
-                     s,
-                     vX,
-                     vT_x,
-                     vT_cal,
-                     vAlpha_i,
-                     vBeta_i);
+  return clv::pnbd_PAlive(r,
+                          s,
+                          vX,
+                          vT_x,
+                          vT_cal,
+                          vAlpha_i,
+                          vBeta_i);
 }
 